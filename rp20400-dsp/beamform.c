@@ -0,0 +1,396 @@
+/*
+ * Fractional-delay delay-and-sum beamforming in DPA
+ */
+
+#include <string.h>
+#include "beamform.h"
+#include "fft.h"
+#include "dpa_vec.h"
+
+// Every beam lags the input by this many samples so the interpolator's
+// look-ahead taps stay inside the loaded block
+#define BEAM_LATENCY        2
+
+// 10^-BEAM_WEIGHT_POINT as a constant, so dropping the weight digits
+// compiles to a multiply rather than a 64-bit division
+#define BEAM_WEIGHT_SCALE   100000000
+#if BEAM_WEIGHT_POINT != -8
+#error "BEAM_WEIGHT_SCALE must be 10^-BEAM_WEIGHT_POINT"
+#endif
+
+// Beam sample at data_point from its accumulator at data_point + BEAM_WEIGHT_POINT
+static inline int32_t beam_round(int64_t acc) {
+    return (int32_t)(acc >= 0 ? (acc + BEAM_WEIGHT_SCALE / 2) / BEAM_WEIGHT_SCALE
+                              : -((-acc + BEAM_WEIGHT_SCALE / 2) / BEAM_WEIGHT_SCALE));
+}
+
+// Round-to-nearest num / den for den > 0
+static int64_t beam_div_round(int64_t num, int64_t den) {
+    return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+// cos and sin of 2*pi*i / FFT_MAX_SIZE in Q(FFT_TWIDDLE_BITS), i in
+// [0, FFT_MAX_SIZE), from the FFT's quarter-wave table
+static void beam_sincos(int i, int32_t *c, int32_t *s) {
+    const int quarter = FFT_MAX_SIZE / 4;
+
+    switch (i / quarter) {
+    case 0:  *c =  fft_quarter_sine[quarter - i];         *s =  fft_quarter_sine[i];                break;
+    case 1:  *c = -fft_quarter_sine[i - quarter];         *s =  fft_quarter_sine[2 * quarter - i];  break;
+    case 2:  *c = -fft_quarter_sine[3 * quarter - i];     *s = -fft_quarter_sine[i - 2 * quarter];  break;
+    default: *c =  fft_quarter_sine[i - 3 * quarter];     *s = -fft_quarter_sine[4 * quarter - i];  break;
+    }
+}
+
+// Cubic Lagrange weights for a fractional position mu = k / BEAM_PHASES
+// between taps 0 and 1, divided by the sensor count. Exact rationals in
+// k and BEAM_PHASES, rounded once to BEAM_WEIGHT_POINT.
+static void beam_lagrange(int k, int num_sensors, int32_t w[BEAM_INTERP_TAPS]) {
+    const int64_t P = BEAM_PHASES;
+    const int64_t m = k;
+    const int64_t num[BEAM_INTERP_TAPS] = {
+        -m * (m - P) * (m - 2 * P),                 // tap -1, over 6 P^3
+        3 * (m + P) * (m - P) * (m - 2 * P),        // tap  0, over 6 P^3
+        -3 * (m + P) * m * (m - 2 * P),             // tap  1, over 6 P^3
+        (m + P) * m * (m - P),                      // tap  2, over 6 P^3
+    };
+    const int64_t den = 6 * P * P * P * num_sensors;
+
+    for (int j = 0; j < BEAM_INTERP_TAPS; j++) {
+        w[j] = (int32_t)beam_div_round(num[j] * dpa_pow10_64[-BEAM_WEIGHT_POINT], den);
+    }
+}
+
+int beamformer_init(beamformer_t *bf, const beam_sensor_t *sensors, int num_sensors,
+                    int32_t sample_rate_hz, dpa_t speed, int data_point) {
+    if (num_sensors < 1 || num_sensors > BEAM_MAX_SENSORS) return -1;
+    if (sample_rate_hz <= 0 || speed.mantissa <= 0) return -1;
+
+    bf->num_sensors = num_sensors;
+    for (int s = 0; s < num_sensors; s++) {
+        bf->pos_x[s] = dpa_mantissa_at(sensors[s].x, -6);
+        bf->pos_y[s] = dpa_mantissa_at(sensors[s].y, -6);
+    }
+    bf->sample_rate_hz = sample_rate_hz;
+    bf->speed_um = speed.point >= -6
+                 ? (int64_t)speed.mantissa * dpa_pow10_64[speed.point + 6]
+                 : speed.mantissa / dpa_pow10_32[-6 - speed.point];
+    if (bf->speed_um <= 0) return -1;
+
+    for (int k = 0; k < BEAM_PHASES; k++) {
+        beam_lagrange(k, num_sensors, bf->weights[k]);
+    }
+
+    bf->data_point = (int8_t)data_point;
+    beamformer_reset(bf);
+    return 0;
+}
+
+void beamformer_reset(beamformer_t *bf) {
+    memset(bf->line, 0, sizeof(bf->line));
+    bf->block_len = 0;
+}
+
+// Plane-wave delay of each sensor for a source at angle_deg, in 1/units
+// sample steps, relative to the earliest sensor (so all are >= 0)
+static void beam_plane_delays(const beamformer_t *bf, dpa_t angle_deg, int64_t units,
+                              int64_t *delay) {
+    // Angle to a table index, one turn = FFT_MAX_SIZE steps
+    int64_t full_turn = 360 * dpa_pow10_64[angle_deg.point < 0 ? -angle_deg.point : 0];
+    int64_t turns = (int64_t)angle_deg.mantissa
+                  * (angle_deg.point > 0 ? dpa_pow10_64[angle_deg.point] : 1);
+    int idx = (int)(beam_div_round(turns * FFT_MAX_SIZE, full_turn) % FFT_MAX_SIZE);
+    if (idx < 0) idx += FFT_MAX_SIZE;
+
+    int32_t c, s;
+    beam_sincos(idx, &c, &s);
+
+    // A sensor further toward the source hears the wavefront earlier by
+    // (r . u) / speed, so it is delayed by that much more
+    int64_t min_delay = INT64_MAX;
+    for (int n = 0; n < bf->num_sensors; n++) {
+        int64_t proj = ((int64_t)bf->pos_x[n] * c + (int64_t)bf->pos_y[n] * s)
+                     >> FFT_TWIDDLE_BITS;
+        delay[n] = beam_div_round(proj * bf->sample_rate_hz * units, bf->speed_um);
+        if (delay[n] < min_delay) min_delay = delay[n];
+    }
+    for (int n = 0; n < bf->num_sensors; n++) {
+        delay[n] -= min_delay;
+    }
+}
+
+int beam_steer(const beamformer_t *bf, dpa_t angle_deg, beam_steering_t *steer) {
+    int64_t delay[BEAM_MAX_SENSORS];
+    beam_plane_delays(bf, angle_deg, BEAM_PHASES, delay);
+
+    for (int n = 0; n < bf->num_sensors; n++) {
+        // Output sample i sits at i - BEAM_LATENCY - delay; split that into
+        // the tap-0 sample i - offset and a fraction phase / BEAM_PHASES
+        int64_t total = delay[n] + BEAM_LATENCY * BEAM_PHASES;
+        int64_t offset = (total + BEAM_PHASES - 1) / BEAM_PHASES;
+        if (offset > BEAM_HISTORY - 1) return -1;
+
+        steer->offset[n] = (int16_t)offset;
+        steer->phase[n] = (uint8_t)(offset * BEAM_PHASES - total);
+    }
+    return 0;
+}
+
+int beam_steer_fan(const beamformer_t *bf, dpa_t start_deg, dpa_t step_deg, int num_beams,
+                   beam_steering_t *steers) {
+    dpa_t angle = start_deg;
+    for (int b = 0; b < num_beams; b++) {
+        if (beam_steer(bf, angle, &steers[b]) != 0) return -1;
+        angle = dpa_add(angle, step_deg);
+    }
+    return 0;
+}
+
+void beamformer_load(beamformer_t *bf, dpa_t channels[][BUFFER_SIZE], int samples) {
+    for (int s = 0; s < bf->num_sensors; s++) {
+        int32_t *line = bf->line[s];
+
+        // Keep the last BEAM_HISTORY samples of the previous block
+        memmove(line, line + bf->block_len, BEAM_HISTORY * sizeof(int32_t));
+
+        for (int i = 0; i < samples; i++) {
+            line[BEAM_HISTORY + i] = dpa_mantissa_at(channels[s][i], bf->data_point);
+        }
+    }
+    bf->block_len = samples;
+}
+
+void beamformer_load_array(beamformer_t *bf, const dpa_array_t *channels) {
+    const int samples = channels[0].length;
+
+    for (int s = 0; s < bf->num_sensors; s++) {
+        int32_t *line = bf->line[s];
+        memmove(line, line + bf->block_len, BEAM_HISTORY * sizeof(int32_t));
+        dpa_array_copy_at(&channels[s], 0, samples, bf->data_point, line + BEAM_HISTORY);
+    }
+    bf->block_len = samples;
+}
+
+// Delay-and-sum accumulators of the loaded block, at the weight point plus
+// data_point
+static const int64_t *beam_form_acc(beamformer_t *bf, const beam_steering_t *steer) {
+    const int n = bf->block_len;
+    int64_t *acc = bf->acc.form;
+
+    memset(acc, 0, n * sizeof(int64_t));
+
+    // One sensor at a time over the whole block, so each pass runs one
+    // fixed set of weights along a contiguous window
+    for (int s = 0; s < bf->num_sensors; s++) {
+        const int32_t *w = bf->weights[steer->phase[s]];
+        const int32_t *x = bf->line[s] + BEAM_HISTORY - steer->offset[s] - 1;
+
+        dpa_correlate_i64(acc, x, w, BEAM_INTERP_TAPS, n);
+    }
+
+    return acc;
+}
+
+void beam_form(beamformer_t *bf, const beam_steering_t *steer, dpa_t *out) {
+    const int64_t *acc = beam_form_acc(bf, steer);
+
+    for (int i = 0; i < bf->block_len; i++) {
+        out[i] = (dpa_t){beam_round(acc[i]), bf->data_point};
+    }
+}
+
+void beam_form_array(beamformer_t *bf, const beam_steering_t *steer, dpa_array_t *out) {
+    const int64_t *acc = beam_form_acc(bf, steer);
+
+    for (int i = 0; i < bf->block_len; i++) {
+        out->mantissa[i] = beam_round(acc[i]);
+    }
+    out->length = bf->block_len;
+    out->point = bf->data_point;
+}
+
+void beam_align(const beamformer_t *bf, const beam_steering_t *steer, int sensor,
+                int32_t *out) {
+    // The weights carry 1/num_sensors; scale the sum back up before rounding
+    const int32_t *w = bf->weights[steer->phase[sensor]];
+    const int32_t *x = bf->line[sensor] + BEAM_HISTORY - steer->offset[sensor] - 1;
+
+    for (int i = 0; i < bf->block_len; i++) {
+        int64_t acc = (int64_t)w[0] * x[i] + (int64_t)w[1] * x[i + 1]
+                    + (int64_t)w[2] * x[i + 2] + (int64_t)w[3] * x[i + 3];
+        out[i] = beam_round(acc * bf->num_sensors);
+    }
+}
+
+// Mean of energy over n samples of data at point, as a dpa_t rounded once
+// to the fewest digits that fit int32
+static dpa_t beam_mean_power(int64_t energy, int n, int point) {
+    dpa_acc_t mean = dpa_acc(2 * point);
+    mean.mantissa = beam_div_round(energy, n > 0 ? n : 1);
+    return dpa_acc_round(mean);
+}
+
+// Up to BEAM_MAX_BEAMS beams of the loaded block, one tile at a time
+static void beam_scan_group(beamformer_t *bf, const beam_steering_t *steers,
+                            int num_beams, int64_t *energy) {
+    int64_t (*acc)[BEAM_TILE] = bf->acc.scan;
+
+    for (int b = 0; b < num_beams; b++) energy[b] = 0;
+
+    for (int t = 0; t < bf->block_len; t += BEAM_TILE) {
+        const int len = bf->block_len - t < BEAM_TILE ? bf->block_len - t : BEAM_TILE;
+        memset(acc, 0, num_beams * sizeof(acc[0]));
+
+        // The tile's window of each sensor stays hot while every beam
+        // takes its delayed, interpolated copy
+        for (int s = 0; s < bf->num_sensors; s++) {
+            const int32_t *window = bf->line[s] + BEAM_HISTORY + t - 1;
+
+            for (int b = 0; b < num_beams; b++) {
+                const int32_t *w = bf->weights[steers[b].phase[s]];
+                const int32_t *x = window - steers[b].offset[s];
+                int64_t *a = acc[b];
+
+                // Whole-sample delays (every beam's reference sensor, and
+                // all sensors at broadside) only need the centre tap
+                if (steers[b].phase[s] == 0) {
+                    dpa_mac_i64(a, x + 1, w[1], len);
+                } else {
+                    dpa_correlate_i64(a, x, w, BEAM_INTERP_TAPS, len);
+                }
+            }
+        }
+
+        for (int b = 0; b < num_beams; b++) {
+            for (int i = 0; i < len; i++) {
+                int64_t y = beam_round(acc[b][i]);
+                energy[b] += y * y;
+            }
+        }
+    }
+}
+
+void beam_scan(beamformer_t *bf, const beam_steering_t *steers, int num_beams,
+               dpa_t *power) {
+    int64_t energy[BEAM_MAX_BEAMS];
+
+    for (int first = 0; first < num_beams; first += BEAM_MAX_BEAMS) {
+        int count = num_beams - first < BEAM_MAX_BEAMS ? num_beams - first : BEAM_MAX_BEAMS;
+        beam_scan_group(bf, steers + first, count, energy);
+
+        for (int b = 0; b < count; b++) {
+            power[first + b] = beam_mean_power(energy[b], bf->block_len, bf->data_point);
+        }
+    }
+}
+
+// ============================================================================
+// FREQUENCY-DOMAIN BEAMFORMING
+// ============================================================================
+
+int beam_fd_steer(const beamformer_t *bf, dpa_t angle_deg, beam_fd_weights_t *w) {
+    // Delays in 1/FFT_MAX_SIZE sample steps, so bin k turns by k * delay / N
+    // table steps
+    int64_t delay[BEAM_MAX_SENSORS];
+    beam_plane_delays(bf, angle_deg, FFT_MAX_SIZE, delay);
+
+    w->num_sensors = bf->num_sensors;
+    for (int n = 0; n < bf->num_sensors; n++) {
+        if (delay[n] >= (int64_t)FFT_SIZE * FFT_MAX_SIZE) return -1;
+        for (int k = 0; k <= FFT_SIZE / 2; k++) {
+            int idx = (int)(beam_div_round(k * delay[n], FFT_SIZE) % FFT_MAX_SIZE);
+            int32_t c, s;
+            beam_sincos(idx, &c, &s);
+
+            // e^(-j 2 pi k delay / N), averaged over the sensors
+            w->w[n][k] = (dpa_cpx_t){c / bf->num_sensors, -s / bf->num_sensors};
+        }
+    }
+    return 0;
+}
+
+// Bring every spectrum onto the coarsest of their block points
+static void beam_fd_align(dpa_cpx_t spectra[][FFT_SIZE / 2 + 1], int num_sensors,
+                          const int8_t *points, int8_t *point) {
+    int8_t common = INT8_MIN;
+    for (int n = 0; n < num_sensors; n++) {
+        if (points[n] > common) common = points[n];
+    }
+
+    for (int n = 0; n < num_sensors; n++) {
+        int digits = common - points[n];
+        if (digits == 0) continue;
+        for (int k = 0; k <= FFT_SIZE / 2; k++) {
+            spectra[n][k].re = (int32_t)dpa_round_digits64(spectra[n][k].re, digits);
+            spectra[n][k].im = (int32_t)dpa_round_digits64(spectra[n][k].im, digits);
+        }
+    }
+
+    *point = common;
+}
+
+int beam_fd_transform(dpa_t channels[][BUFFER_SIZE], int num_sensors,
+                      dpa_cpx_t spectra[][FFT_SIZE / 2 + 1], int8_t *point) {
+    int8_t points[BEAM_MAX_SENSORS];
+
+    for (int n = 0; n < num_sensors; n++) {
+        if (dpa_fft_real(channels[n], spectra[n], FFT_SIZE, &points[n]) != 0) return -1;
+    }
+    beam_fd_align(spectra, num_sensors, points, point);
+    return 0;
+}
+
+int beam_fd_transform_array(const dpa_array_t *channels, int num_sensors,
+                            dpa_cpx_t spectra[][FFT_SIZE / 2 + 1], int8_t *point) {
+    int8_t points[BEAM_MAX_SENSORS];
+
+    for (int n = 0; n < num_sensors; n++) {
+        if (dpa_fft_real_array(&channels[n], spectra[n], FFT_SIZE, &points[n]) != 0) return -1;
+    }
+    beam_fd_align(spectra, num_sensors, points, point);
+    return 0;
+}
+
+void beam_fd_form(dpa_cpx_t spectra[][FFT_SIZE / 2 + 1], const beam_fd_weights_t *w,
+                  dpa_cpx_t *out) {
+    const int64_t round = (int64_t)1 << (FFT_TWIDDLE_BITS - 1);
+
+    for (int k = 0; k <= FFT_SIZE / 2; k++) {
+        int64_t re = 0, im = 0;
+        for (int n = 0; n < w->num_sensors; n++) {
+            dpa_cpx_t x = spectra[n][k], c = w->w[n][k];
+            re += (int64_t)x.re * c.re - (int64_t)x.im * c.im;
+            im += (int64_t)x.re * c.im + (int64_t)x.im * c.re;
+        }
+        out[k] = (dpa_cpx_t){(int32_t)((re + round) >> FFT_TWIDDLE_BITS),
+                             (int32_t)((im + round) >> FFT_TWIDDLE_BITS)};
+    }
+}
+
+void beam_fd_scan(dpa_cpx_t spectra[][FFT_SIZE / 2 + 1], int8_t point,
+                  const beam_fd_weights_t *w, int num_beams, dpa_t *power) {
+    dpa_cpx_t beam[FFT_SIZE / 2 + 1];
+
+    for (int b = 0; b < num_beams; b++) {
+        beam_fd_form(spectra, &w[b], beam);
+
+        // Drop digits until the squares can be summed without overflow
+        int32_t peak = 0;
+        for (int k = 0; k <= FFT_SIZE / 2; k++) {
+            int32_t m = beam[k].re < 0 ? -beam[k].re : beam[k].re;
+            if (m > peak) peak = m;
+            m = beam[k].im < 0 ? -beam[k].im : beam[k].im;
+            if (m > peak) peak = m;
+        }
+        int digits = 0;
+        for (; peak >= (1 << 26); peak /= 10) digits++;
+
+        int64_t energy = 0;
+        for (int k = 0; k <= FFT_SIZE / 2; k++) {
+            int64_t re = dpa_round_digits64(beam[k].re, digits);
+            int64_t im = dpa_round_digits64(beam[k].im, digits);
+            energy += re * re + im * im;
+        }
+        power[b] = beam_mean_power(energy, FFT_SIZE / 2 + 1, point + digits);
+    }
+}
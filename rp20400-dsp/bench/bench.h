@@ -0,0 +1,69 @@
+/*
+ * Host benchmark helpers
+ *
+ * Wall-clock timing via CLOCK_MONOTONIC and, on x86, the time-stamp counter
+ * so results can be quoted both in ns/op and ops/cycle.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#else
+#define BENCH_HAVE_TSC 0
+#endif
+
+typedef struct {
+    uint64_t ns;
+    uint64_t cycles;
+} bench_stamp_t;
+
+static inline bench_stamp_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    bench_stamp_t s;
+    s.ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#if BENCH_HAVE_TSC
+    s.cycles = __rdtsc();
+#else
+    s.cycles = 0;
+#endif
+    return s;
+}
+
+// Small, fast PRNG so operand generation never shows up in the timings
+static inline uint32_t bench_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Uniform integer in [lo, hi], any int32 bounds (the span and the offset
+// are formed in 64 bits, so [INT32_MIN, INT32_MAX] works too)
+static inline int32_t bench_rand_range(uint32_t *state, int32_t lo, int32_t hi) {
+    const uint64_t span = (uint64_t)((int64_t)hi - lo) + 1;
+    return (int32_t)(lo + (int64_t)(bench_rand(state) % span));
+}
+
+static inline void bench_report(const char *name, bench_stamp_t t0, bench_stamp_t t1,
+                                uint64_t ops) {
+    double ns = (double)(t1.ns - t0.ns);
+    double cycles = (double)(t1.cycles - t0.cycles);
+    if (cycles > 0) {
+        printf("%-24s %8.3f ns/op %8.3f cycles/op %8.3f ops/cycle\n",
+               name, ns / ops, cycles / ops, ops / cycles);
+    } else {
+        printf("%-24s %8.3f ns/op\n", name, ns / ops);
+    }
+}
+
+#endif // BENCH_H
@@ -0,0 +1,145 @@
+/*
+ * Shared-point arrays: conversion checks, footprint and kernel throughput
+ *
+ * Random dpa_t blocks with mixed points go through dpa_array_from_dpa and
+ * back: values that fit one point must survive exactly, and blocks that
+ * do not must come back rounded to the chosen point. dpa_array_rescale is
+ * checked against dpa_round_digits64. Then the pipeline buffers are sized
+ * both ways, and the FIR decimator and real FFT are timed on dpa_t input
+ * against the same data as a shared-point array.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "fir.h"
+#include "fft.h"
+#include "pipeline.h"
+
+#define BLOCK       256
+#define TRIALS      20000
+#define REPEATS     2000
+
+static dpa_t   values[BLOCK];
+static dpa_t   back[BLOCK];
+static int32_t mantissas[BLOCK];
+
+// Exact comparison of two dpa_t values, either point
+static int dpa_equal(dpa_t a, dpa_t b) {
+    int p = a.point < b.point ? a.point : b.point;
+    return (int64_t)a.mantissa * dpa_pow10_64[a.point - p] ==
+           (int64_t)b.mantissa * dpa_pow10_64[b.point - p];
+}
+
+static int check_conversions(void) {
+    uint32_t seed = 0xA77u;
+    int failures = 0;
+
+    for (int t = 0; t < TRIALS; t++) {
+        // Half the trials stay inside one int32 point (lossless), half
+        // mix magnitudes that force a coarser one
+        const int wide = t & 1;
+        for (int i = 0; i < BLOCK; i++) {
+            int32_t m = bench_rand_range(&seed, -99999, 99999);
+            if (wide) m = (int32_t)bench_rand(&seed) >> bench_rand_range(&seed, 1, 20);
+            values[i] = (dpa_t){m, (int8_t)bench_rand_range(&seed, -6, wide ? 3 : -2)};
+        }
+        if (t % 7 == 0) memset(values, 0, sizeof(values));
+
+        dpa_array_t a = dpa_array(mantissas, 0, 0);
+        dpa_array_from_dpa(&a, values, BLOCK);
+        dpa_array_to_dpa(&a, back);
+        failures += a.length != BLOCK;
+
+        for (int i = 0; i < BLOCK; i++) {
+            int shift = values[i].point - a.point;
+            dpa_t expected = shift >= 0 ? values[i]
+                : (dpa_t){(int32_t)dpa_round_digits64(values[i].mantissa, -shift), a.point};
+            failures += !dpa_equal(back[i], expected);
+            if (!wide) failures += !dpa_equal(back[i], values[i]);
+        }
+
+        // Coarser by two digits, then back: rounded, never truncated
+        dpa_array_rescale(&a, a.point + 2);
+        for (int i = 0; i < BLOCK; i++) {
+            failures += a.mantissa[i] != (int32_t)dpa_round_digits64(back[i].mantissa, 2);
+        }
+    }
+
+    printf("dpa_array conversions: %d trials of %d, %d wrong\n", TRIALS, BLOCK, failures);
+    return failures;
+}
+
+static void report_footprint(void) {
+    size_t soa = sizeof(((dsp_block_t *)0)->signal) + sizeof(((dsp_block_t *)0)->beam);
+    size_t aos = (size_t)(ADC_CHANNELS * BUFFER_SIZE + DECIMATED_SIZE) * sizeof(dpa_t);
+    printf("pipeline sample buffers per block: %zu bytes as dpa_t, %zu as mantissas "
+           "(x%d blocks in flight)\n", aos, soa, PIPELINE_DEPTH);
+}
+
+static int bench_kernels(void) {
+    static const fir_design_t lowpass = {fir_coeffs, FIR_TAPS, FIR_GENERAL, DPA_DECIMAL};
+    static fir_decimator_t dec;
+    static dpa_t   in_dpa[BUFFER_SIZE], out_dpa[BUFFER_SIZE];
+    static int32_t in_m[BUFFER_SIZE], out_m[BUFFER_SIZE];
+    static dpa_cpx_t spectrum_dpa[FFT_SIZE / 2 + 1], spectrum_m[FFT_SIZE / 2 + 1];
+    uint32_t seed = 0xF00Du;
+    int mismatches = 0;
+
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        in_m[i] = bench_rand_range(&seed, -2048, 2047) * 10000;
+        in_dpa[i] = (dpa_t){in_m[i], FIR_INPUT_POINT};
+    }
+    const dpa_array_t in = dpa_array(in_m, BUFFER_SIZE, FIR_INPUT_POINT);
+    dpa_array_t out = dpa_array(out_m, 0, 0);
+
+    fir_decimator_init(&dec, &lowpass, DECIMATION_FACTOR, FIR_INPUT_POINT);
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        fir_decimate_block(&dec, in_dpa, out_dpa, BUFFER_SIZE);
+    }
+    bench_stamp_t t1 = bench_now();
+    bench_report("fir_decimate_block", t0, t1, (uint64_t)REPEATS * BUFFER_SIZE);
+
+    fir_decimator_init(&dec, &lowpass, DECIMATION_FACTOR, FIR_INPUT_POINT);
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        fir_decimate_array(&dec, &in, &out);
+    }
+    t1 = bench_now();
+    bench_report("fir_decimate_array", t0, t1, (uint64_t)REPEATS * BUFFER_SIZE);
+
+    for (int i = 0; i < out.length; i++) {
+        mismatches += out.mantissa[i] != out_dpa[i].mantissa;
+    }
+
+    int8_t point_dpa = 0, point_m = 0;
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        dpa_fft_real(in_dpa, spectrum_dpa, FFT_SIZE, &point_dpa);
+    }
+    t1 = bench_now();
+    bench_report("dpa_fft_real", t0, t1, (uint64_t)REPEATS);
+
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        dpa_fft_real_array(&in, spectrum_m, FFT_SIZE, &point_m);
+    }
+    t1 = bench_now();
+    bench_report("dpa_fft_real_array", t0, t1, (uint64_t)REPEATS);
+
+    mismatches += point_dpa != point_m;
+    mismatches += memcmp(spectrum_dpa, spectrum_m, sizeof(spectrum_m)) != 0;
+    printf("%-24s %d mismatches between the dpa_t and array paths\n", "", mismatches);
+    return mismatches;
+}
+
+int main(void) {
+    int failures = check_conversions();
+    report_footprint();
+
+    printf("\nKernels on dpa_t vs shared-point input (per sample / per transform)\n");
+    failures += bench_kernels();
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
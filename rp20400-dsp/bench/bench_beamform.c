@@ -0,0 +1,288 @@
+/*
+ * Fractional-delay beamformer harness
+ *
+ * An 8-sensor line array (half a wavelength apart at 1 kHz) hears a 1 kHz
+ * plane wave from SOURCE_DEG. The harness:
+ *   - steers at the source and compares several streamed blocks against
+ *     a double-precision delay-and-sum using the engine's own quantised
+ *     delays, so only interpolation and rounding error remain
+ *   - scans 0..180 degrees and checks the power peak lands on the source
+ *   - times beam_form, then beams/second for 1..64-beam power maps, with
+ *     beam_scan against forming each beam separately (which must agree
+ *     bit for bit)
+ *   - repeats the steering and scan checks for the frequency-domain path
+ *     against a double-precision DFT beamformer, and times its beams/s
+ * Exits non-zero if an error, a direction estimate or the map is off.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "beamform.h"
+
+#define SENSORS      8
+#define SPACING_UM   171500         // half a wavelength at 1 kHz
+#define TONE_HZ      1000.0
+#define AMPLITUDE    1500.0         // ADC counts
+#define SOURCE_DEG   50
+#define BLOCKS       6
+#define SCAN_STEP    5
+#define SCAN_BEAMS   (180 / SCAN_STEP + 1)
+#define REPEATS      2000
+#define MAP_SAMPLES  (1 << 18)      // beam-samples timed per map size
+#define MAX_ERROR    0.03           // of AMPLITUDE
+#define MAX_FD_ERROR 0.002          // of the reference spectrum peak
+#define FD_BEAMS     64
+
+static beamformer_t bf;
+static dpa_t channels[BEAM_MAX_SENSORS][BUFFER_SIZE];
+static dpa_t beam[BUFFER_SIZE];
+
+static const dpa_t speed = {SOUND_SPEED_MM_S, -3};
+
+// Sensor s at sample n: the wavefront reaches sensors further toward the
+// source earlier by (r . u) / c
+static double sensor_signal(int s, double n, double source_deg) {
+    double c = SOUND_SPEED_MM_S / 1000.0;
+    double lead = s * SPACING_UM * 1e-6 * cos(source_deg * M_PI / 180.0) / c;
+    return AMPLITUDE * sin(2.0 * M_PI * TONE_HZ * (n / SAMPLE_RATE_HZ + lead));
+}
+
+static void fill_block(int block) {
+    for (int s = 0; s < SENSORS; s++) {
+        for (int i = 0; i < BUFFER_SIZE; i++) {
+            double v = sensor_signal(s, block * BUFFER_SIZE + i, SOURCE_DEG);
+            channels[s][i] = (dpa_t){(int32_t)lround(v * 1e4), FIR_INPUT_POINT};
+        }
+    }
+}
+
+static int check_steered(const beam_steering_t *steer) {
+    double worst = 0.0;
+
+    beamformer_reset(&bf);
+    for (int b = 0; b < BLOCKS; b++) {
+        fill_block(b);
+        beamformer_load(&bf, channels, BUFFER_SIZE);
+        beam_form(&bf, steer, beam);
+        if (b == 0) continue;   // the first block starts from silent history
+
+        for (int i = 0; i < BUFFER_SIZE; i++) {
+            double ref = 0.0;
+            for (int s = 0; s < SENSORS; s++) {
+                double delay = steer->offset[s] - steer->phase[s] / (double)BEAM_PHASES;
+                ref += sensor_signal(s, b * BUFFER_SIZE + i - delay, SOURCE_DEG);
+            }
+            ref /= SENSORS;
+
+            double got = beam[i].mantissa * pow(10.0, beam[i].point);
+            worst = fmax(worst, fabs(got - ref));
+        }
+    }
+
+    printf("steered at %d deg: max |error| %.4f counts (%.3f%% of amplitude)\n",
+           SOURCE_DEG, worst, 100.0 * worst / AMPLITUDE);
+    return worst <= MAX_ERROR * AMPLITUDE ? 0 : 1;
+}
+
+// One beam_form call per direction, then the same mean-square rounding
+// as beam_scan
+static void scan_per_beam(const beam_steering_t *steers, int num_beams, dpa_t *power) {
+    for (int b = 0; b < num_beams; b++) {
+        beam_form(&bf, &steers[b], beam);
+
+        int64_t energy = 0;
+        for (int i = 0; i < BUFFER_SIZE; i++) {
+            energy += (int64_t)beam[i].mantissa * beam[i].mantissa;
+        }
+        dpa_acc_t mean = dpa_acc(2 * FIR_INPUT_POINT);
+        mean.mantissa = (energy + BUFFER_SIZE / 2) / BUFFER_SIZE;
+        power[b] = dpa_acc_round(mean);
+    }
+}
+
+static int bench_maps(void) {
+    static const int counts[] = {1, 4, 16, 32, 64};
+    static beam_steering_t fan[BEAM_MAX_BEAMS];
+    dpa_t power[BEAM_MAX_BEAMS], expected[BEAM_MAX_BEAMS];
+    int mismatches = 0;
+
+    for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        const int beams = counts[c];
+        const int repeats = MAP_SAMPLES / (beams * BUFFER_SIZE) + 1;
+        char name[32];
+
+        // Spread the fan over 0..180 degrees in 1/10 degree steps
+        beam_steer_fan(&bf, (dpa_t){0, 0}, (dpa_t){1800 / beams, -1}, beams, fan);
+
+        scan_per_beam(fan, beams, expected);
+        beam_scan(&bf, fan, beams, power);
+        for (int b = 0; b < beams; b++) {
+            if (power[b].mantissa != expected[b].mantissa || power[b].point != expected[b].point) {
+                mismatches++;
+            }
+        }
+
+        bench_stamp_t t0 = bench_now();
+        for (int r = 0; r < repeats; r++) scan_per_beam(fan, beams, expected);
+        bench_stamp_t t1 = bench_now();
+        double per_beam = (double)(t1.ns - t0.ns) / ((double)repeats * beams);
+
+        t0 = bench_now();
+        for (int r = 0; r < repeats; r++) beam_scan(&bf, fan, beams, power);
+        t1 = bench_now();
+        double scan = (double)(t1.ns - t0.ns) / ((double)repeats * beams);
+
+        snprintf(name, sizeof(name), "%d beams", beams);
+        printf("%-24s per-beam %9.0f beams/s   beam_scan %9.0f beams/s   (%.2fx)\n",
+               name, 1e9 / per_beam, 1e9 / scan, per_beam / scan);
+    }
+
+    printf("beam-power maps: %d mismatches against per-beam forming\n", mismatches);
+    return mismatches ? 1 : 0;
+}
+
+static int check_scan(const beam_steering_t *steers) {
+    dpa_t power[SCAN_BEAMS];
+    beam_scan(&bf, steers, SCAN_BEAMS, power);
+
+    int peak = 0;
+    double peak_power = 0.0;
+    printf("scan power (dB re peak):");
+    for (int b = 0; b < SCAN_BEAMS; b++) {
+        double p = power[b].mantissa * pow(10.0, power[b].point);
+        if (p > peak_power) {
+            peak_power = p;
+            peak = b;
+        }
+    }
+    for (int b = 0; b < SCAN_BEAMS; b += 3) {
+        double p = power[b].mantissa * pow(10.0, power[b].point);
+        printf(" %d:%.0f", b * SCAN_STEP, 10.0 * log10(fmax(p, 1e-12) / peak_power));
+    }
+    printf("\npeak at %d deg (source %d deg)\n", peak * SCAN_STEP, SOURCE_DEG);
+    return peak * SCAN_STEP == SOURCE_DEG ? 0 : 1;
+}
+
+static double plane_delay(int s, double steer_deg) {
+    // Delay (samples) of sensor s when steering at steer_deg; sensor 0 sits
+    // at the origin, so shift by the most negative projection
+    double c = SOUND_SPEED_MM_S / 1000.0;
+    double u = cos(steer_deg * M_PI / 180.0);
+    double proj = s * SPACING_UM * 1e-6 * u;
+    double min = u < 0 ? (SENSORS - 1) * SPACING_UM * 1e-6 * u : 0.0;
+    return (proj - min) / c * SAMPLE_RATE_HZ;
+}
+
+static int check_fd(void) {
+    static dpa_cpx_t spectra[BEAM_MAX_SENSORS][FFT_SIZE / 2 + 1];
+    static beam_fd_weights_t fan[FD_BEAMS];
+    dpa_cpx_t out[FFT_SIZE / 2 + 1];
+    int8_t point;
+    int failures = 0;
+
+    fill_block(1);
+    if (beam_fd_transform(channels, SENSORS, spectra, &point) != 0) {
+        printf("beam_fd_transform failed\n");
+        return 1;
+    }
+
+    // Steered at the source: compare every bin with a double DFT beamformer
+    beam_fd_weights_t w;
+    beam_fd_steer(&bf, (dpa_t){SOURCE_DEG, 0}, &w);
+    beam_fd_form(spectra, &w, out);
+
+    double worst = 0.0, peak = 0.0;
+    for (int k = 0; k <= FFT_SIZE / 2; k++) {
+        double re = 0.0, im = 0.0;
+        for (int s = 0; s < SENSORS; s++) {
+            double d = plane_delay(s, SOURCE_DEG);
+            for (int n = 0; n < FFT_SIZE; n++) {
+                double v = channels[s][n].mantissa * pow(10.0, channels[s][n].point);
+                double a = -2.0 * M_PI * k * (n + d) / FFT_SIZE;
+                re += v * cos(a);
+                im += v * sin(a);
+            }
+        }
+        re /= SENSORS;
+        im /= SENSORS;
+
+        double scale = pow(10.0, point);
+        double err = hypot(out[k].re * scale - re, out[k].im * scale - im);
+        worst = fmax(worst, err);
+        peak = fmax(peak, hypot(re, im));
+    }
+    printf("frequency domain, steered at %d deg: max bin error %.5f of peak\n",
+           SOURCE_DEG, worst / peak);
+    if (worst > MAX_FD_ERROR * peak) failures++;
+
+    // Power map over 0..180 degrees
+    dpa_t power[FD_BEAMS];
+    for (int b = 0; b < SCAN_BEAMS; b++) {
+        beam_fd_steer(&bf, (dpa_t){b * SCAN_STEP, 0}, &fan[b]);
+    }
+    beam_fd_scan(spectra, point, fan, SCAN_BEAMS, power);
+    int best = 0;
+    for (int b = 1; b < SCAN_BEAMS; b++) {
+        double p = power[b].mantissa * pow(10.0, power[b].point);
+        if (p > power[best].mantissa * pow(10.0, power[best].point)) best = b;
+    }
+    printf("frequency domain peak at %d deg (source %d deg)\n", best * SCAN_STEP, SOURCE_DEG);
+    if (best * SCAN_STEP != SOURCE_DEG) failures++;
+
+    // Throughput: one transform per block, then a multiply-accumulate per
+    // bin and sensor for each beam
+    for (int b = 0; b < FD_BEAMS; b++) {
+        beam_fd_steer(&bf, (dpa_t){b * 1800 / FD_BEAMS, -1}, &fan[b]);
+    }
+    const int repeats = MAP_SAMPLES / (FD_BEAMS * FFT_SIZE) + 1;
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < repeats; r++) {
+        beam_fd_transform(channels, SENSORS, spectra, &point);
+    }
+    bench_stamp_t t1 = bench_now();
+    bench_report("fd transform (per blk)", t0, t1, repeats);
+
+    t0 = bench_now();
+    for (int r = 0; r < repeats; r++) {
+        beam_fd_scan(spectra, point, fan, FD_BEAMS, power);
+    }
+    t1 = bench_now();
+    double per_beam = (double)(t1.ns - t0.ns) / ((double)repeats * FD_BEAMS);
+    printf("%-24s %9.0f beams/s of %d-point frames\n", "fd 64-beam map", 1e9 / per_beam,
+           FFT_SIZE);
+
+    return failures;
+}
+
+int main(void) {
+    beam_sensor_t sensors[SENSORS];
+    for (int s = 0; s < SENSORS; s++) {
+        sensors[s] = (beam_sensor_t){{s * SPACING_UM, -6}, {0, 0}};
+    }
+    if (beamformer_init(&bf, sensors, SENSORS, SAMPLE_RATE_HZ, speed, FIR_INPUT_POINT) != 0) {
+        printf("beamformer_init failed\n");
+        return EXIT_FAILURE;
+    }
+
+    static beam_steering_t steers[SCAN_BEAMS];
+    if (beam_steer_fan(&bf, (dpa_t){0, 0}, (dpa_t){SCAN_STEP, 0}, SCAN_BEAMS, steers) != 0) {
+        printf("beam_steer_fan failed\n");
+        return EXIT_FAILURE;
+    }
+
+    int failures = check_steered(&steers[SOURCE_DEG / SCAN_STEP]);
+    failures += check_scan(steers);
+
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        beam_form(&bf, &steers[r % SCAN_BEAMS], beam);
+    }
+    bench_stamp_t t1 = bench_now();
+    bench_report("beam_form (per sample)", t0, t1, (uint64_t)REPEATS * BUFFER_SIZE);
+
+    failures += bench_maps();
+    failures += check_fd();
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
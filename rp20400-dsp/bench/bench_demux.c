@@ -0,0 +1,62 @@
+/*
+ * ADC demux benchmark
+ *
+ * Feeds adc_demux a synthetic interleaved capture whose samples encode
+ * their channel and frame index, checks every converted value against
+ * the expected channel row, then times the conversion per frame.
+ */
+
+#include <stdlib.h>
+#include "bench.h"
+#include "dpa_array.h"
+#include "dsp.h"
+
+#define REPEATS 20000
+
+static uint16_t capture[BUFFER_SIZE * ADC_CHANNELS];
+static int32_t  planar[ADC_CHANNELS][BUFFER_SIZE];
+
+static uint16_t synthetic_sample(int ch, int i) {
+    return (uint16_t)((ch * 1000 + i * 7) & 0x0FFF);
+}
+
+static int check_demux(void) {
+    int mismatches = 0;
+    for (int ch = 0; ch < ADC_CHANNELS; ch++) {
+        // Each row is documented as mantissas at FIR_INPUT_POINT: read that
+        // way, every value must be the offset-removed sample exactly
+        const dpa_array_t row = dpa_array(planar[ch], BUFFER_SIZE, FIR_INPUT_POINT);
+        for (int i = 0; i < BUFFER_SIZE; i++) {
+            const dpa_t expected = {(int32_t)synthetic_sample(ch, i) - ADC_MIDSCALE, 0};
+            const dpa_t got = dpa_array_get(&row, i);
+            if (dpa_mantissa_at(got, expected.point) != expected.mantissa ||
+                dpa_mantissa_at(expected, got.point) != got.mantissa) {
+                mismatches++;
+            }
+        }
+    }
+    return mismatches;
+}
+
+int main(void) {
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        for (int ch = 0; ch < ADC_CHANNELS; ch++) {
+            capture[i * ADC_CHANNELS + ch] = synthetic_sample(ch, i);
+        }
+    }
+
+    adc_demux(capture, planar, BUFFER_SIZE);
+    int mismatches = check_demux();
+    printf("adc_demux: %d channels x %d frames, %d mismatches\n",
+           ADC_CHANNELS, BUFFER_SIZE, mismatches);
+
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        adc_demux(capture, planar, BUFFER_SIZE);
+    }
+    bench_stamp_t t1 = bench_now();
+    bench_report("adc_demux (per sample)", t0, t1,
+                 (uint64_t)REPEATS * BUFFER_SIZE * ADC_CHANNELS);
+
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
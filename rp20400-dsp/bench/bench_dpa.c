@@ -0,0 +1,432 @@
+/*
+ * Throughput benchmark for the DPA core primitives
+ *
+ * Runs dpa_add, dpa_multiply, dpa_from_int and dpa_to_int over large random
+ * operand sets and reports ns/op and ops/cycle for each, then compares
+ * dpa_add against the original loop-scaled version for every point
+ * difference the alignment path handles.
+ *
+ * dpa_multiply is first checked against an exact reference over every
+ * pair of a set of edge mantissas (powers of ten and two and their
+ * neighbours, the int32 limits) plus millions of random pairs: the
+ * result must be the product rounded half away from zero with the fewest
+ * digits dropped. It is then timed against the original /1000 version on
+ * products that fit and products that overflow.
+ *
+ * Sums of products through dpa_acc_t are checked against an exact 128-bit
+ * reference rounded once, with a count of the sums the dpa_add /
+ * dpa_multiply chain they replace would overflow, and timed against that
+ * chain.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "dpa.h"
+
+#define NUM_OPERANDS (1 << 20)
+#define REPEATS      16
+
+static dpa_t   operand_a[NUM_OPERANDS];
+static dpa_t   operand_b[NUM_OPERANDS];
+static int32_t operand_i[NUM_OPERANDS];
+static int     operand_p[NUM_OPERANDS];
+
+// Results are stored here so the loops cannot be optimised away
+static volatile int32_t sink;
+
+// Largest mantissa for an operand `digits` decimal digits coarser than its
+// partner: scaled up by dpa_add it stays within 2^30, so adding the partner
+// (at most 2^15) cannot overflow int32
+static int32_t operand_limit(int digits) {
+    if (digits <= 0 || (1 << 30) / dpa_pow10_32[digits] >= 32767) return 32767;
+    return (1 << 30) / dpa_pow10_32[digits];
+}
+
+static void fill_operands(void) {
+    uint32_t seed = 0x2040u;
+    for (int i = 0; i < NUM_OPERANDS; i++) {
+        int pa = bench_rand_range(&seed, -6, 0), pb = bench_rand_range(&seed, -6, 0);
+        int32_t la = operand_limit(pa - pb), lb = operand_limit(pb - pa);
+        operand_a[i] = (dpa_t){bench_rand_range(&seed, -la - 1, la), (int8_t)pa};
+        operand_b[i] = (dpa_t){bench_rand_range(&seed, -lb - 1, lb), (int8_t)pb};
+        operand_i[i] = bench_rand_range(&seed, -2048, 2047);
+        operand_p[i] = bench_rand_range(&seed, 0, 5);
+    }
+}
+
+// dpa_multiply as it was: a flat /1000 (truncating) on any overflow
+static inline dpa_t dpa_multiply_div1000(dpa_t a, dpa_t b) {
+    int64_t result = (int64_t)a.mantissa * b.mantissa;
+    if (result > INT32_MAX || result < INT32_MIN) {
+        result /= 1000;
+        return (dpa_t){(int32_t)result, a.point + b.point + 3};
+    }
+    return (dpa_t){(int32_t)result, a.point + b.point};
+}
+
+// dpa_add with the original `scale *= 10` loops, kept as the baseline
+static inline dpa_t dpa_add_loop(dpa_t a, dpa_t b) {
+    if (a.point == b.point) {
+        return (dpa_t){a.mantissa + b.mantissa, a.point};
+    }
+    
+    if (a.point > b.point) {
+        if (a.mantissa == 0) return b;
+        int shift = a.point - b.point;
+        if (shift > DPA_POW10_32_MAX) return a;
+        int32_t scale = 1;
+        for (int i = 0; i < shift; i++) scale *= 10;
+        return (dpa_t){a.mantissa * scale + b.mantissa, b.point};
+    } else {
+        if (b.mantissa == 0) return a;
+        int shift = b.point - a.point;
+        if (shift > DPA_POW10_32_MAX) return b;
+        int32_t scale = 1;
+        for (int i = 0; i < shift; i++) scale *= 10;
+        return (dpa_t){a.mantissa + b.mantissa * scale, a.point};
+    }
+}
+
+static void bench_add(void) {
+    int32_t acc = 0;
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i++) {
+            acc ^= dpa_add(operand_a[i], operand_b[i]).mantissa;
+        }
+    }
+    bench_stamp_t t1 = bench_now();
+    sink = acc;
+    bench_report("dpa_add", t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+}
+
+static void bench_multiply(void) {
+    int32_t acc = 0;
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i++) {
+            acc ^= dpa_multiply(operand_a[i], operand_b[i]).mantissa;
+        }
+    }
+    bench_stamp_t t1 = bench_now();
+    sink = acc;
+    bench_report("dpa_multiply", t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+}
+
+static void bench_from_int(void) {
+    int32_t acc = 0;
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i++) {
+            acc ^= dpa_from_int(operand_i[i], operand_p[i]).mantissa;
+        }
+    }
+    bench_stamp_t t1 = bench_now();
+    sink = acc;
+    bench_report("dpa_from_int", t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+}
+
+static void bench_to_int(void) {
+    int32_t acc = 0;
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i++) {
+            acc ^= dpa_to_int(operand_a[i]);
+        }
+    }
+    bench_stamp_t t1 = bench_now();
+    sink = acc;
+    bench_report("dpa_to_int", t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+}
+
+// Reference: p rounded half away from zero with the fewest digits dropped,
+// by plain division
+static int reference_round(int64_t p, int32_t *mantissa) {
+    for (int d = 0; ; d++) {
+        int64_t scale = dpa_pow10_64[d];
+        int64_t q = p / scale, r = p % scale;
+        if (2 * (r < 0 ? -r : r) >= scale) q += p < 0 ? -1 : 1;
+        if (q >= -INT32_MAX && q <= INT32_MAX) {
+            *mantissa = (int32_t)q;
+            return d;
+        }
+    }
+}
+
+static int reference_product(int32_t a, int32_t b, int32_t *mantissa) {
+    return reference_round((int64_t)a * b, mantissa);
+}
+
+static int check_pair(int32_t a, int32_t b, int8_t pa, int8_t pb, double *old_worst) {
+    int32_t expected;
+    int d = reference_product(a, b, &expected);
+    
+    unsigned flags = 0;
+    dpa_t r = dpa_multiply_flags((dpa_t){a, pa}, (dpa_t){b, pb}, &flags);
+    int bad = r.mantissa != expected || r.point != pa + pb + d ||
+              ((flags & DPA_INEXACT) != 0) != (d > 0) || (flags & DPA_SATURATED);
+    
+    // Relative error of the old version on the same pair
+    double exact = (double)a * b;
+    if (exact != 0.0) {
+        dpa_t o = dpa_multiply_div1000((dpa_t){a, 0}, (dpa_t){b, 0});
+        double err = fabs(o.mantissa * pow(10.0, o.point) - exact) / fabs(exact);
+        if (err > *old_worst) *old_worst = err;
+    }
+    return bad;
+}
+
+static int check_multiply(void) {
+    static int32_t edges[512];
+    int n = 0;
+    
+    for (int k = 0; k <= DPA_POW10_32_MAX; k++) {
+        int32_t p = dpa_pow10_32[k];
+        edges[n++] = p;
+        edges[n++] = p - 1;
+        if (p < INT32_MAX) edges[n++] = p + 1;
+    }
+    for (int k = 0; k < 31; k++) {
+        edges[n++] = (int32_t)(1u << k);
+        edges[n++] = (int32_t)((1u << k) - 1);
+    }
+    edges[n++] = INT32_MAX;
+    edges[n++] = 46340;     // floor(sqrt(2^31))
+    edges[n++] = 46341;
+    edges[n++] = 2147483;   // rounding carries at the int32 edge
+    edges[n++] = 21474836;
+    edges[n++] = 214748365;
+    uint32_t seed = 0x5EEDu;
+    while (n < 256) edges[n++] = (int32_t)(bench_rand(&seed) >> 1);
+    for (int i = 0, m = n; i < m; i++) edges[n++] = edges[i] == INT32_MAX ? INT32_MIN : -edges[i];
+    
+    int failures = 0;
+    long pairs = 0;
+    double old_worst = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            failures += check_pair(edges[i], edges[j], -6, -4, &old_worst);
+            pairs++;
+        }
+    }
+    for (long i = 0; i < (1L << 24); i++) {
+        int32_t a = (int32_t)bench_rand(&seed);
+        int32_t b = (int32_t)bench_rand(&seed) >> bench_rand_range(&seed, 0, 31);
+        failures += check_pair(a, b, (int8_t)bench_rand_range(&seed, -12, 6),
+                               (int8_t)bench_rand_range(&seed, -12, 6), &old_worst);
+        pairs++;
+    }
+    
+    // Point range: overflow saturates, underflow rounds toward zero
+    unsigned flags = 0;
+    dpa_t big = dpa_multiply_flags((dpa_t){2000000000, 100}, (dpa_t){-3, 100}, &flags);
+    failures += big.mantissa != -INT32_MAX || big.point != INT8_MAX || !(flags & DPA_SATURATED);
+    flags = 0;
+    dpa_t tiny = dpa_multiply_flags((dpa_t){15, -64}, (dpa_t){1, -65}, &flags);
+    failures += tiny.mantissa != 2 || tiny.point != INT8_MIN || flags != DPA_INEXACT;
+    
+    printf("dpa_multiply: %ld pairs, %d wrong; old /1000 version worst relative error %.3g\n",
+           pairs, failures, old_worst);
+    return failures;
+}
+
+static void bench_multiply_vs_old(const char *what, int32_t lo, int32_t hi) {
+    uint32_t seed = 0xA11u;
+    for (int i = 0; i < NUM_OPERANDS; i++) {
+        operand_a[i] = (dpa_t){bench_rand_range(&seed, lo, hi), -6};
+        operand_b[i] = (dpa_t){bench_rand_range(&seed, lo, hi), -4};
+    }
+    
+    char name[40];
+    int32_t acc = 0;
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i++) {
+            acc ^= dpa_multiply(operand_a[i], operand_b[i]).mantissa;
+        }
+    }
+    bench_stamp_t t1 = bench_now();
+    snprintf(name, sizeof(name), "  %s new", what);
+    bench_report(name, t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+    
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i++) {
+            acc ^= dpa_multiply_div1000(operand_a[i], operand_b[i]).mantissa;
+        }
+    }
+    t1 = bench_now();
+    snprintf(name, sizeof(name), "  %s /1000", what);
+    bench_report(name, t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+    sink = acc;
+}
+
+// Cycles per dpa_add for each point difference, table vs loop
+static void bench_add_by_shift(void) {
+    printf("\ndpa_add by point difference (table vs loop)\n");
+    for (int shift = 0; shift <= DPA_POW10_32_MAX; shift++) {
+        // Small non-zero mantissas so every shift scales inside int32
+        for (int i = 0; i < NUM_OPERANDS; i++) {
+            operand_a[i].mantissa = (operand_a[i].mantissa & 1) + 1;
+            operand_a[i].point = (int8_t)-shift;
+            operand_b[i].mantissa = (operand_b[i].mantissa & 1) + 1;
+            operand_b[i].point = 0;
+        }
+
+        char name[32];
+        int32_t acc = 0;
+        bench_stamp_t t0 = bench_now();
+        for (int r = 0; r < REPEATS; r++) {
+            for (int i = 0; i < NUM_OPERANDS; i++) {
+                acc ^= dpa_add(operand_a[i], operand_b[i]).mantissa;
+            }
+        }
+        bench_stamp_t t1 = bench_now();
+        snprintf(name, sizeof(name), "  shift %d table", shift);
+        bench_report(name, t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+
+        t0 = bench_now();
+        for (int r = 0; r < REPEATS; r++) {
+            for (int i = 0; i < NUM_OPERANDS; i++) {
+                acc ^= dpa_add_loop(operand_a[i], operand_b[i]).mantissa;
+            }
+        }
+        t1 = bench_now();
+        snprintf(name, sizeof(name), "  shift %d loop", shift);
+        bench_report(name, t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+        sink = acc;
+    }
+}
+
+// Reductions of ACC_TERMS products at mixed points: dpa_acc_mac must hold
+// the exact sum and dpa_acc_round must round it once. Operand points span
+// four digits, so the scaled-up terms stay inside int64. The dpa_add chain
+// over dpa_multiply is followed on the same sums in int64, counting the
+// sums whose int32 mantissa it would overflow.
+#define ACC_TERMS   64
+#define ACC_TRIALS  200000
+
+// One dpa_add step of the chain, aligned the same way but in int64: 0 when
+// dpa_add's mantissa would overflow
+static int chain_add(dpa_t *sum, dpa_t x) {
+    dpa_t a = *sum, b = x;
+    if (a.point < b.point) {
+        dpa_t t = a;
+        a = b;
+        b = t;
+    }
+    // a is now the coarser (or equal) operand
+    const int shift = a.point - b.point;
+    if (shift > DPA_POW10_32_MAX && a.mantissa != 0) {
+        *sum = a;
+        return 1;
+    }
+    int64_t m = b.mantissa;
+    if (shift <= DPA_POW10_32_MAX) m += (int64_t)a.mantissa * dpa_pow10_32[shift];
+    if (m > INT32_MAX || m < INT32_MIN) return 0;
+    *sum = (dpa_t){(int32_t)m, b.point};
+    return 1;
+}
+
+static int check_accumulate(void) {
+    uint32_t seed = 0xACCu;
+    int failures = 0, chain_overflows = 0;
+    
+    for (int t = 0; t < ACC_TRIALS; t++) {
+        dpa_t a[ACC_TERMS], b[ACC_TERMS];
+        int point = 0;
+        for (int i = 0; i < ACC_TERMS; i++) {
+            a[i] = (dpa_t){bench_rand_range(&seed, -32768, 32767),
+                           (int8_t)bench_rand_range(&seed, -4, 0)};
+            b[i] = (dpa_t){bench_rand_range(&seed, -32768, 32767),
+                           (int8_t)bench_rand_range(&seed, -4, 0)};
+            if (a[i].point + b[i].point < point) point = a[i].point + b[i].point;
+        }
+        
+        dpa_acc_t acc = dpa_acc(point);
+        dpa_t chain = {0, 0};
+        int chain_ok = 1;
+        __int128 exact = 0;
+        for (int i = 0; i < ACC_TERMS; i++) {
+            dpa_acc_mac(&acc, a[i], b[i]);
+            if (chain_ok) chain_ok = chain_add(&chain, dpa_multiply(a[i], b[i]));
+            exact += (__int128)a[i].mantissa * b[i].mantissa
+                   * dpa_pow10_64[a[i].point + b[i].point - point];
+        }
+        failures += acc.mantissa != exact;
+        chain_overflows += !chain_ok;
+        
+        int32_t expected;
+        int d = reference_round(acc.mantissa, &expected);
+        dpa_t r = dpa_acc_round(acc);
+        failures += r.mantissa != expected || r.point != point + d;
+    }
+    
+    printf("dpa_acc: %d sums of %d products, %d wrong; dpa_add chain overflows int32 in %d\n",
+           ACC_TRIALS, ACC_TERMS, failures, chain_overflows);
+    return failures;
+}
+
+// Timed on operands small enough that the dpa_add chain stays inside int32:
+// product points span four digits, so 64 * 57^2 * 10^4 < 2^31
+static void bench_accumulate(void) {
+    uint32_t seed = 0xACC2u;
+    for (int i = 0; i < NUM_OPERANDS; i++) {
+        operand_a[i] = (dpa_t){bench_rand_range(&seed, -57, 57),
+                               (int8_t)bench_rand_range(&seed, -2, 0)};
+        operand_b[i] = (dpa_t){bench_rand_range(&seed, -57, 57),
+                               (int8_t)bench_rand_range(&seed, -2, 0)};
+    }
+    
+    int32_t acc = 0;
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i += ACC_TERMS) {
+            dpa_acc_t sum = dpa_acc(-4);
+            for (int k = 0; k < ACC_TERMS; k++) {
+                dpa_acc_mac(&sum, operand_a[i + k], operand_b[i + k]);
+            }
+            acc ^= dpa_acc_round(sum).mantissa;
+        }
+    }
+    bench_stamp_t t1 = bench_now();
+    bench_report("dpa_acc_mac + round", t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+    
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (int i = 0; i < NUM_OPERANDS; i += ACC_TERMS) {
+            dpa_t sum = {0, 0};
+            for (int k = 0; k < ACC_TERMS; k++) {
+                sum = dpa_add(sum, dpa_multiply(operand_a[i + k], operand_b[i + k]));
+            }
+            acc ^= sum.mantissa;
+        }
+    }
+    t1 = bench_now();
+    bench_report("  dpa_add(dpa_multiply)", t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);
+    sink = acc;
+}
+
+int main(void) {
+    int failures = check_multiply();
+    failures += check_accumulate();
+    fill_operands();
+
+    printf("DPA primitive throughput (%d operands x %d repeats)\n",
+           NUM_OPERANDS, REPEATS);
+    bench_add();
+    bench_multiply();
+    bench_from_int();
+    bench_to_int();
+    bench_add_by_shift();
+
+    printf("\ndpa_multiply, normalising vs /1000\n");
+    bench_multiply_vs_old("fits int32", -32768, 32767);
+    bench_multiply_vs_old("overflows", -2000000000, 2000000000);
+
+    printf("\nReductions of %d products (per term)\n", ACC_TERMS);
+    bench_accumulate();
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,234 @@
+/*
+ * Decimal vs binary DPA primitives
+ *
+ * dpa2_multiply is checked against an exact reference over every pair of a
+ * set of edge mantissas plus millions of random pairs, and dpa2_to_int and
+ * the dpa_t <-> dpa2_t conversions against plain 128-bit division. Then
+ * add, multiply, from_int and to_int are timed for dpa_t and dpa2_t, with
+ * points drawn from matching ranges (0..6 decimal digits vs 0..20 bits of
+ * alignment) and each coarser mantissa bounded so the aligned sum fits.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "dpa2.h"
+
+#define NUM_OPERANDS (1 << 20)
+#define REPEATS      16
+
+static dpa_t   dec_a[NUM_OPERANDS];
+static dpa_t   dec_b[NUM_OPERANDS];
+static dpa2_t  bin_a[NUM_OPERANDS];
+static dpa2_t  bin_b[NUM_OPERANDS];
+static int32_t operand_i[NUM_OPERANDS];
+static int     operand_p[NUM_OPERANDS];
+
+// Results are stored here so the loops cannot be optimised away
+static volatile int32_t sink;
+
+// Reference: the product rounded half away from zero with the fewest bits
+// dropped, by plain division
+static int reference_product(int32_t a, int32_t b, int32_t *mantissa) {
+    int64_t p = (int64_t)a * b;
+    for (int d = 0; ; d++) {
+        int64_t scale = (int64_t)1 << d;
+        int64_t q = p / scale, r = p % scale;
+        if (2 * (r < 0 ? -r : r) >= scale) q += p < 0 ? -1 : 1;
+        if (q >= -INT32_MAX && q <= INT32_MAX) {
+            *mantissa = (int32_t)q;
+            return d;
+        }
+    }
+}
+
+static int check_pair(int32_t a, int32_t b, int8_t pa, int8_t pb) {
+    int32_t expected;
+    int d = reference_product(a, b, &expected);
+
+    unsigned flags = 0;
+    dpa2_t r = dpa2_multiply_flags((dpa2_t){a, pa}, (dpa2_t){b, pb}, &flags);
+    return r.mantissa != expected || r.point != pa + pb + d ||
+           ((flags & DPA_INEXACT) != 0) != (d > 0) || (flags & DPA_SATURATED);
+}
+
+static int check_multiply(void) {
+    static int32_t edges[256];
+    int n = 0;
+
+    for (int k = 0; k < 31; k++) {
+        edges[n++] = (int32_t)(1u << k);
+        edges[n++] = (int32_t)((1u << k) - 1);
+        edges[n++] = (int32_t)((1u << k) + 1);
+    }
+    edges[n++] = INT32_MAX;
+    edges[n++] = 46340;     // floor(sqrt(2^31))
+    edges[n++] = 46341;
+    uint32_t seed = 0x5EEDu;
+    while (n < 128) edges[n++] = (int32_t)(bench_rand(&seed) >> 1);
+    for (int i = 0, m = n; i < m; i++) edges[n++] = edges[i] == INT32_MAX ? INT32_MIN : -edges[i];
+
+    int failures = 0;
+    long pairs = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            failures += check_pair(edges[i], edges[j], -20, -12);
+            pairs++;
+        }
+    }
+    for (long i = 0; i < (1L << 24); i++) {
+        int32_t a = (int32_t)bench_rand(&seed);
+        int32_t b = (int32_t)bench_rand(&seed) >> bench_rand_range(&seed, 0, 31);
+        failures += check_pair(a, b, (int8_t)bench_rand_range(&seed, -40, 20),
+                               (int8_t)bench_rand_range(&seed, -40, 20));
+        pairs++;
+    }
+
+    // Point range: overflow saturates, underflow rounds toward zero
+    unsigned flags = 0;
+    dpa2_t big = dpa2_multiply_flags((dpa2_t){2000000000, 100}, (dpa2_t){-3, 100}, &flags);
+    failures += big.mantissa != -INT32_MAX || big.point != INT8_MAX || !(flags & DPA_SATURATED);
+    flags = 0;
+    dpa2_t tiny = dpa2_multiply_flags((dpa2_t){3, -64}, (dpa2_t){1, -66}, &flags);
+    failures += tiny.mantissa != 1 || tiny.point != INT8_MIN || flags != DPA_INEXACT;
+
+    printf("dpa2_multiply: %ld pairs, %d wrong\n", pairs, failures);
+    return failures;
+}
+
+// num / den rounded half away from zero, den > 0, in 128 bits
+static int64_t reference_ratio(__int128 num, __int128 den) {
+    __int128 q = num / den, r = num % den;
+    if (2 * (r < 0 ? -r : r) >= den) q += num < 0 ? -1 : 1;
+    return (int64_t)q;
+}
+
+// to_int truncates toward zero; conversions round to nearest
+static int check_conversions(void) {
+    uint32_t seed = 0xC0Bu;
+    int failures = 0;
+
+    for (long i = 0; i < (1L << 22); i++) {
+        int32_t m = (int32_t)bench_rand(&seed) >> bench_rand_range(&seed, 0, 31);
+        int shift = bench_rand_range(&seed, 1, 31);
+        int32_t expected = (int32_t)(m / ((int64_t)1 << shift));
+        failures += dpa2_to_int((dpa2_t){m, (int8_t)-shift}) != expected;
+
+        // Decimal value to a binary point that puts it near 2^30, and back
+        dpa_t x = {(int32_t)bench_rand(&seed) >> 8, (int8_t)bench_rand_range(&seed, -9, 9)};
+        if (x.mantissa == 0) continue;
+        double v = fabs(x.mantissa * pow(10.0, x.point));
+        int bits = 29 - (int)ceil(log2(v));
+        if (bits > 31) bits = 31;
+        if (bits < -31) bits = -31;
+        __int128 num = x.mantissa, den = 1;
+        for (int k = 0; k < abs(x.point); k++) {
+            if (x.point > 0) num *= 10;
+            else             den *= 10;
+        }
+        // Scale by multiplying: left-shifting a negative num is undefined
+        if (bits >= 0) num *= (__int128)1 << bits;
+        else           den <<= -bits;
+        dpa2_t b = dpa2_from_dpa(x, -bits);
+        failures += b.mantissa != reference_ratio(num, den);
+
+        // Back to the original decimal point
+        num = b.mantissa;
+        den = (__int128)1 << (bits > 0 ? bits : 0);
+        if (bits < 0) num *= (__int128)1 << -bits;
+        for (int k = 0; k < abs(x.point); k++) {
+            if (x.point > 0) den *= 10;
+            else             num *= 10;
+        }
+        failures += dpa_from_dpa2(b, x.point).mantissa != reference_ratio(num, den);
+    }
+
+    printf("dpa2 to_int and conversions: %d wrong\n", failures);
+    return failures;
+}
+
+// Largest mantissa for an operand `digits` decimal digits and `bits` bits
+// coarser than its partner: scaled up, it stays within 2^30, so adding the
+// partner (at most 2^15) cannot overflow int32 in either representation
+static int32_t operand_limit(int digits, int bits) {
+    int64_t limit = 32767;
+    if (digits > 0 && ((int64_t)1 << 30) / dpa_pow10_32[digits] < limit) {
+        limit = ((int64_t)1 << 30) / dpa_pow10_32[digits];
+    }
+    if (bits > 0 && ((int64_t)1 << 30) >> bits < limit) limit = ((int64_t)1 << 30) >> bits;
+    return (int32_t)limit;
+}
+
+static void fill_operands(void) {
+    uint32_t seed = 0x2040u;
+    for (int i = 0; i < NUM_OPERANDS; i++) {
+        int pa = bench_rand_range(&seed, -6, 0), pb = bench_rand_range(&seed, -6, 0);
+        int qa = bench_rand_range(&seed, -20, 0), qb = bench_rand_range(&seed, -20, 0);
+        int32_t la = operand_limit(pa - pb, qa - qb), lb = operand_limit(pb - pa, qb - qa);
+        int32_t ma = bench_rand_range(&seed, -la - 1, la);
+        int32_t mb = bench_rand_range(&seed, -lb - 1, lb);
+        dec_a[i] = (dpa_t){ma, (int8_t)pa};
+        dec_b[i] = (dpa_t){mb, (int8_t)pb};
+        bin_a[i] = (dpa2_t){ma, (int8_t)qa};
+        bin_b[i] = (dpa2_t){mb, (int8_t)qb};
+        operand_i[i] = bench_rand_range(&seed, -2048, 2047);
+        operand_p[i] = bench_rand_range(&seed, 0, 5);
+    }
+}
+
+// One timed loop per primitive and mode; EXPR sees the operands at index i.
+// The results are summed unsigned, so the sum wraps instead of overflowing.
+#define BENCH_LOOP(name, expr)                                              \
+    do {                                                                    \
+        uint32_t acc = 0;                                                   \
+        bench_stamp_t t0 = bench_now();                                     \
+        for (int r = 0; r < REPEATS; r++) {                                 \
+            for (int i = 0; i < NUM_OPERANDS; i++) {                        \
+                acc += (uint32_t)(expr);                                    \
+            }                                                               \
+        }                                                                   \
+        bench_stamp_t t1 = bench_now();                                     \
+        sink = (int32_t)acc;                                                \
+        bench_report(name, t0, t1, (uint64_t)REPEATS * NUM_OPERANDS);       \
+    } while (0)
+
+static void bench_primitives(void) {
+    BENCH_LOOP("dpa_add", dpa_add(dec_a[i], dec_b[i]).mantissa);
+    BENCH_LOOP("dpa2_add", dpa2_add(bin_a[i], bin_b[i]).mantissa);
+    BENCH_LOOP("dpa_multiply", dpa_multiply(dec_a[i], dec_b[i]).mantissa);
+    BENCH_LOOP("dpa2_multiply", dpa2_multiply(bin_a[i], bin_b[i]).mantissa);
+    BENCH_LOOP("dpa_from_int", dpa_from_int(operand_i[i], operand_p[i]).mantissa);
+    BENCH_LOOP("dpa2_from_int", dpa2_from_int(operand_i[i], operand_p[i]).mantissa);
+    BENCH_LOOP("dpa_to_int", dpa_to_int(dec_a[i]));
+    BENCH_LOOP("dpa2_to_int", dpa2_to_int(bin_a[i]));
+}
+
+// Products that overflow int32, so every multiply normalises
+static void bench_multiply_overflow(void) {
+    uint32_t seed = 0xA11u;
+    for (int i = 0; i < NUM_OPERANDS; i++) {
+        int32_t ma = bench_rand_range(&seed, -2000000000, 2000000000);
+        int32_t mb = bench_rand_range(&seed, -2000000000, 2000000000);
+        dec_a[i] = (dpa_t){ma, -6};
+        dec_b[i] = (dpa_t){mb, -4};
+        bin_a[i] = (dpa2_t){ma, -20};
+        bin_b[i] = (dpa2_t){mb, -12};
+    }
+
+    printf("\nmultiply, products overflowing int32\n");
+    BENCH_LOOP("  dpa_multiply", dpa_multiply(dec_a[i], dec_b[i]).mantissa);
+    BENCH_LOOP("  dpa2_multiply", dpa2_multiply(bin_a[i], bin_b[i]).mantissa);
+}
+
+int main(void) {
+    int failures = check_multiply();
+    failures += check_conversions();
+    fill_operands();
+
+    printf("\nDecimal vs binary primitives (%d operands x %d repeats)\n",
+           NUM_OPERANDS, REPEATS);
+    bench_primitives();
+    bench_multiply_overflow();
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
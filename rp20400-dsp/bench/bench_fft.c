@@ -0,0 +1,210 @@
+/*
+ * FFT benchmark: dpa_fft over every supported size, against dpa_dft
+ *
+ * Reports the cost per frame, the real-time load at SAMPLE_RATE_HZ (frame
+ * time / frame period) and the worst bin error relative to the peak bin of
+ * a double-precision DFT of the same input. The generated twiddle tables
+ * are checked against double-precision sines first. Exits non-zero if a
+ * table entry is off by more than half an ulp or an error passes the
+ * bounds below.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "dsp.h"
+#include "fft.h"
+
+// Each size runs about this many samples after one warm-up frame, so the
+// small transforms are timed over enough frames to be steady
+#define TIMED_SAMPLES (1 << 20)
+#define MIN_REPEATS   64
+
+// Worst bin error relative to the peak bin, and the largest difference
+// between dpa_fft_real and dpa_fft in lsb of the coarser output point
+#define FFT_MAX_REL_ERROR  1e-7
+#define DFT_MAX_REL_ERROR  1e-4
+#define REAL_MAX_LSB_DIFF  16
+
+static dpa_t     input[FFT_MAX_SIZE];
+static dpa_cpx_t data[FFT_MAX_SIZE];
+static double    ref_re[FFT_MAX_SIZE], ref_im[FFT_MAX_SIZE];
+
+static void fill_input(int N, int decimal_places) {
+    uint32_t seed = 0xFF7u;
+    for (int i = 0; i < N; i++) {
+        // Two tones plus noise, 12-bit range
+        double x = 900.0 * sin(2.0 * M_PI * 5.0 * i / N)
+                 + 400.0 * cos(2.0 * M_PI * 13.0 * i / N);
+        int32_t sample = (int32_t)lround(x) + bench_rand_range(&seed, -64, 64);
+        input[i] = dpa_from_int(sample, decimal_places);
+    }
+}
+
+static void reference_dft(int N) {
+    for (int k = 0; k < N; k++) {
+        double re = 0.0, im = 0.0;
+        for (int n = 0; n < N; n++) {
+            double x = input[n].mantissa * pow(10.0, input[n].point);
+            re += x * cos(2.0 * M_PI * k * n / N);
+            im -= x * sin(2.0 * M_PI * k * n / N);
+        }
+        ref_re[k] = re;
+        ref_im[k] = im;
+    }
+}
+
+static double relative_error_bins(const dpa_cpx_t *bins, int count, int8_t point) {
+    double scale = pow(10.0, point), peak = 0.0, worst = 0.0;
+    for (int k = 0; k < count; k++) {
+        peak = fmax(peak, hypot(ref_re[k], ref_im[k]));
+        worst = fmax(worst, hypot(bins[k].re * scale - ref_re[k],
+                                  bins[k].im * scale - ref_im[k]));
+    }
+    return worst / peak;
+}
+
+static double relative_error(int N, int8_t point) {
+    return relative_error_bins(data, N, point);
+}
+
+static int repeats_for(int N) {
+    return TIMED_SAMPLES / N > MIN_REPEATS ? TIMED_SAMPLES / N : MIN_REPEATS;
+}
+
+static int bench_fft_size(int N) {
+    char name[32];
+    int8_t point = 0;
+
+    fill_input(N, 4);
+    const int repeats = repeats_for(N);
+    bench_stamp_t t0 = {0, 0}, t1 = {0, 0};
+    for (int r = 0; r <= repeats; r++) {
+        if (r == 1) t0 = bench_now(); // first frame warms up
+        point = dpa_fft_load_real(input, data, N);
+        dpa_fft(data, N, &point);
+    }
+    t1 = bench_now();
+
+    snprintf(name, sizeof(name), "dpa_fft N=%d", N);
+    bench_report(name, t0, t1, repeats);
+
+    double frame_ns = (double)(t1.ns - t0.ns) / repeats;
+    double period_ns = 1e9 * N / SAMPLE_RATE_HZ;
+    reference_dft(N);
+    double error = relative_error(N, point);
+    printf("%-24s load %.5f  rel. error %.2e\n", "", frame_ns / period_ns, error);
+    return error > FFT_MAX_REL_ERROR;
+}
+
+// Real-input FFT against the full complex transform of the same frame
+static int bench_fft_real(int N) {
+    static dpa_cpx_t half[FFT_MAX_SIZE / 2 + 1];
+    char name[32];
+    int8_t point = 0, full_point = 0;
+
+    fill_input(N, 4);
+    const int repeats = repeats_for(N);
+    bench_stamp_t t0 = {0, 0}, t1 = {0, 0};
+    for (int r = 0; r <= repeats; r++) {
+        if (r == 1) t0 = bench_now();
+        dpa_fft_real(input, half, N, &point);
+    }
+    t1 = bench_now();
+
+    snprintf(name, sizeof(name), "dpa_fft_real N=%d", N);
+    bench_report(name, t0, t1, repeats);
+
+    full_point = dpa_fft_load_real(input, data, N);
+    dpa_fft(data, N, &full_point);
+
+    // Compare in units of the coarser block point
+    int8_t common = point > full_point ? point : full_point;
+    int64_t worst = 0;
+    for (int k = 0; k <= N / 2; k++) {
+        int64_t dr = dpa_mantissa_at((dpa_t){half[k].re, point}, common)
+                   - dpa_mantissa_at((dpa_t){data[k].re, full_point}, common);
+        int64_t di = dpa_mantissa_at((dpa_t){half[k].im, point}, common)
+                   - dpa_mantissa_at((dpa_t){data[k].im, full_point}, common);
+        if (llabs(dr) > worst) worst = llabs(dr);
+        if (llabs(di) > worst) worst = llabs(di);
+    }
+    reference_dft(N);
+    double error = relative_error_bins(half, N / 2 + 1, point);
+    printf("%-24s vs dpa_fft max diff %lld lsb @ 10^%d  rel. error %.2e\n", "",
+           (long long)worst, common, error);
+    return error > FFT_MAX_REL_ERROR || worst > REAL_MAX_LSB_DIFF;
+}
+
+static int bench_dft(int N) {
+    static dpa_t re[FFT_MAX_SIZE], im[FFT_MAX_SIZE];
+    static int32_t work[DPA_DFT_WORK(FFT_SIZE)];
+    char name[32];
+
+    // The same samples as the FFTs: dpa_dft sums each bin exactly in int64
+    fill_input(N, 4);
+    const int repeats = repeats_for(N);
+    bench_stamp_t t0 = {0, 0}, t1 = {0, 0};
+    int status = 0;
+    for (int r = 0; r <= repeats; r++) {
+        if (r == 1) t0 = bench_now();
+        status |= dpa_dft(input, re, im, N, work);
+    }
+    t1 = bench_now();
+    if (status != 0) {
+        printf("dpa_dft rejected N=%d\n", N);
+        return 1;
+    }
+
+    snprintf(name, sizeof(name), "dpa_dft N=%d", N);
+    bench_report(name, t0, t1, repeats);
+
+    reference_dft(N);
+    double peak = 0.0, worst = 0.0;
+    for (int k = 0; k < N / 2; k++) {
+        peak = fmax(peak, hypot(ref_re[k], ref_im[k]));
+        worst = fmax(worst, hypot(re[k].mantissa * pow(10.0, re[k].point) - ref_re[k],
+                                  im[k].mantissa * pow(10.0, im[k].point) - ref_im[k]));
+    }
+    printf("%-24s rel. error %.2e\n", "", worst / peak);
+    return worst / peak > DFT_MAX_REL_ERROR;
+}
+
+// Worst table entry error in units of the last place
+static int check_twiddles(void) {
+    double fft_lsb = ldexp(1.0, -FFT_TWIDDLE_BITS), fft_worst = 0.0;
+    for (int i = 0; i <= FFT_MAX_SIZE / 4; i++) {
+        double exact = sin(2.0 * M_PI * i / FFT_MAX_SIZE);
+        fft_worst = fmax(fft_worst, fabs(fft_quarter_sine[i] * fft_lsb - exact) / fft_lsb);
+    }
+
+    double dft_lsb = pow(10.0, -DFT_TWIDDLE_DIGITS), dft_worst = 0.0;
+    for (int i = 0; i <= FFT_SIZE / 4; i++) {
+        double exact = sin(2.0 * M_PI * i / FFT_SIZE);
+        dft_worst = fmax(dft_worst, fabs(dft_quarter_sine[i] * dft_lsb - exact) / dft_lsb);
+    }
+
+    printf("Twiddle tables\n");
+    printf("  fft_quarter_sine %5d entries Q%d     max error %.3f ulp\n",
+           FFT_MAX_SIZE / 4 + 1, FFT_TWIDDLE_BITS, fft_worst);
+    printf("  dft_quarter_sine %5d entries 10^-%d  max error %.3f ulp\n\n",
+           FFT_SIZE / 4 + 1, DFT_TWIDDLE_DIGITS, dft_worst);
+    return (fft_worst > 0.5) + (dft_worst > 0.5);
+}
+
+int main(void) {
+    int failures = check_twiddles();
+
+    printf("FFT throughput (per frame)\n");
+    for (int N = FFT_MIN_SIZE; N <= FFT_MAX_SIZE; N <<= 1) {
+        failures += bench_fft_size(N);
+    }
+    printf("\n");
+    for (int N = FFT_MIN_SIZE; N <= FFT_MAX_SIZE; N <<= 1) {
+        failures += bench_fft_real(N);
+    }
+    printf("\n");
+    failures += bench_dft(FFT_SIZE);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/*
+ * Compile-time-point DPA (dpa_fixed.hpp): checks and FIR throughput
+ *
+ * dpa_fixed sums, products, rescales and dpa_t conversions are checked
+ * against dpa_add, dpa_multiply, dpa_acc_round and dpa_round_digits64 on
+ * random operands. Then the 32-tap low-pass runs per tap three ways on
+ * the same mirrored delay line: dpa_t samples summed with dpa_acc_mac
+ * (points carried at runtime), dpa_fixed samples and coefficients (points
+ * in the type) and bare int32 mantissas with the points kept by hand, plus
+ * fir_process_block. All four must agree bit for bit, and dpa_fixed should
+ * cost what the hand-written mantissa loop does.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include "bench.h"
+#include "dpa_fixed.hpp"
+#include "fir.h"
+
+#define TRIALS      (1 << 20)
+#define NUM_SAMPLES (1 << 16)
+#define REPEATS     8
+
+// The low-pass design's coefficient point (fir_coeffs are all at 10^-6)
+#define COEFF_POINT (-6)
+
+typedef dpa_fixed<FIR_INPUT_POINT> sample_t;
+typedef dpa_fixed<COEFF_POINT>     coeff_t;
+
+// Results are stored here so the loops cannot be optimised away
+static volatile int32_t sink;
+
+static dpa_t dpa(int32_t mantissa, int point) {
+    dpa_t x = {mantissa, (int8_t)point};
+    return x;
+}
+
+static int same(dpa_t a, dpa_t b) {
+    return a.mantissa == b.mantissa && a.point == b.point;
+}
+
+static int check_ops(void) {
+    uint32_t seed = 0xF1Du;
+    int failures = 0;
+
+    for (int t = 0; t < TRIALS; t++) {
+        const dpa_fixed<-6> a = dpa_fixed<-6>::from_mantissa(bench_rand_range(&seed, -99999, 99999));
+        const dpa_fixed<-3> b = dpa_fixed<-3>::from_mantissa(bench_rand_range(&seed, -99999, 99999));
+        const dpa_t da = a, db = b;
+
+        // The sum lands at the finer point, as dpa_add aligns it
+        dpa_fixed<-6> sum = a + b, diff = a - b;
+        failures += !same(sum, dpa_add(da, db));
+        failures += !same(diff, dpa_add(da, dpa(-db.mantissa, db.point)));
+
+        // Products are exact; rounded once they match dpa_multiply
+        dpa_fixed_acc<-9> p = a * b;
+        failures += p.mantissa != (int64_t)da.mantissa * db.mantissa;
+        failures += !same(p.to_dpa(), dpa_multiply(da, db));
+
+        // Rescales round half away from zero, scale-ups are exact
+        failures += a.rescale<-2>().mantissa != (int32_t)dpa_round_digits64(a.mantissa, 4);
+        failures += b.rescale<-5>().mantissa != b.mantissa * 100;
+        failures += p.round<-4>().mantissa != (int32_t)dpa_round_digits64(p.mantissa, 5);
+
+        // From dpa_t at any point
+        const int32_t m = bench_rand_range(&seed, -99999, 99999);
+        const dpa_t x = dpa(m, bench_rand_range(&seed, -9, 0));
+        const int shift = x.point - FIR_INPUT_POINT;
+        const int32_t expected = shift >= 0 ? x.mantissa * dpa_pow10_32[shift]
+                                            : (int32_t)dpa_round_digits64(x.mantissa, -shift);
+        failures += sample_t(x).mantissa != expected;
+    }
+
+    // The points are constants: this all folds at compile time
+    constexpr dpa_fixed<-2> half = dpa_fixed<-1>::from_mantissa(5) + dpa_fixed<-2>::from_int(0);
+    static_assert(half.mantissa == 50 && decltype(half)::point == -2, "sum point");
+    static_assert(dpa_fixed<-3>::from_mantissa(1234).rescale<-1>().mantissa == 12, "rescale");
+    static_assert((dpa_fixed<-3>::from_mantissa(-1250) * dpa_fixed<-1>::from_mantissa(4))
+                      .round<-2>().mantissa == -50, "product");
+
+    printf("dpa_fixed: %d operand sets, %d wrong\n", TRIALS, failures);
+    return failures;
+}
+
+static dpa_t    input[NUM_SAMPLES];
+static dpa_t    output_dpa[NUM_SAMPLES], output_block[NUM_SAMPLES];
+static sample_t output_fixed[NUM_SAMPLES];
+
+// Per-tap FIR on a mirrored delay line (oldest first), coefficients reversed
+// to match, as fir.c lays them out. Runtime points: every tap goes through
+// dpa_acc_mac's alignment check.
+static dpa_t dpa_delay[2 * FIR_TAPS], dpa_reversed[FIR_TAPS];
+
+static void fir_runtime(const dpa_t *in, dpa_t *out, int n) {
+    int index = 0;
+    memset(dpa_delay, 0, sizeof(dpa_delay));
+    for (int s = 0; s < n; s++) {
+        if (++index == FIR_TAPS) index = 0;
+        dpa_delay[index] = dpa_delay[index + FIR_TAPS] = in[s];
+
+        dpa_acc_t acc = dpa_acc(COEFF_POINT + FIR_INPUT_POINT);
+        for (int k = 0; k < FIR_TAPS; k++) {
+            dpa_acc_mac(&acc, dpa_reversed[k], dpa_delay[index + 1 + k]);
+        }
+        out[s] = dpa((int32_t)dpa_round_digits64(acc.mantissa, FIR_INPUT_POINT - acc.point),
+                     FIR_INPUT_POINT);
+    }
+}
+
+// The same loop with the points in the types
+static sample_t fixed_delay[2 * FIR_TAPS];
+static coeff_t  fixed_reversed[FIR_TAPS];
+
+static void fir_fixed(const dpa_t *in, sample_t *out, int n) {
+    int index = 0;
+    for (int k = 0; k < 2 * FIR_TAPS; k++) fixed_delay[k] = sample_t();
+    for (int s = 0; s < n; s++) {
+        if (++index == FIR_TAPS) index = 0;
+        fixed_delay[index] = fixed_delay[index + FIR_TAPS] = sample_t(in[s]);
+
+        dpa_fixed_acc<COEFF_POINT + FIR_INPUT_POINT> acc;
+        for (int k = 0; k < FIR_TAPS; k++) {
+            acc += fixed_reversed[k] * fixed_delay[index + 1 + k];
+        }
+        out[s] = acc.round<FIR_INPUT_POINT>();
+    }
+}
+
+// And by hand on bare mantissas, the way fir.c does it
+static int32_t raw_delay[2 * FIR_TAPS], raw_reversed[FIR_TAPS];
+static int32_t output_raw[NUM_SAMPLES];
+
+static void fir_raw(const dpa_t *in, int32_t *out, int n) {
+    int index = 0;
+    memset(raw_delay, 0, sizeof(raw_delay));
+    for (int s = 0; s < n; s++) {
+        if (++index == FIR_TAPS) index = 0;
+        raw_delay[index] = raw_delay[index + FIR_TAPS] = dpa_mantissa_at(in[s], FIR_INPUT_POINT);
+
+        int64_t acc = 0;
+        for (int k = 0; k < FIR_TAPS; k++) {
+            acc += (int64_t)raw_reversed[k] * raw_delay[index + 1 + k];
+        }
+        out[s] = (int32_t)dpa_round_digits64(acc, -COEFF_POINT);
+    }
+}
+
+static int bench_fir(void) {
+    uint32_t seed = 0xF12u;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        input[i] = dpa_from_int(bench_rand_range(&seed, -2048, 2047), -FIR_INPUT_POINT);
+    }
+    for (int k = 0; k < FIR_TAPS; k++) {
+        dpa_reversed[k] = fir_coeffs[FIR_TAPS - 1 - k];
+        fixed_reversed[k] = coeff_t(dpa_reversed[k]);
+        raw_reversed[k] = fixed_reversed[k].mantissa;
+    }
+
+    bench_stamp_t t0 = {0, 0}, t1 = {0, 0};
+    for (int r = 0; r < REPEATS; r++) {
+        if (r == 1) t0 = bench_now(); // first pass warms up
+        fir_runtime(input, output_dpa, NUM_SAMPLES);
+    }
+    t1 = bench_now();
+    bench_report("dpa_t + dpa_acc_mac", t0, t1, (uint64_t)(REPEATS - 1) * NUM_SAMPLES);
+
+    for (int r = 0; r < REPEATS; r++) {
+        if (r == 1) t0 = bench_now();
+        fir_fixed(input, output_fixed, NUM_SAMPLES);
+    }
+    t1 = bench_now();
+    bench_report("dpa_fixed", t0, t1, (uint64_t)(REPEATS - 1) * NUM_SAMPLES);
+
+    for (int r = 0; r < REPEATS; r++) {
+        if (r == 1) t0 = bench_now();
+        fir_raw(input, output_raw, NUM_SAMPLES);
+    }
+    t1 = bench_now();
+    bench_report("int32 mantissas", t0, t1, (uint64_t)(REPEATS - 1) * NUM_SAMPLES);
+
+    static fir_state_t st;
+    static const fir_design_t lowpass = {fir_coeffs, FIR_TAPS, FIR_GENERAL, DPA_DECIMAL};
+    fir_init(&st, &lowpass, FIR_INPUT_POINT);
+    for (int r = 0; r < REPEATS; r++) {
+        fir_reset(&st);
+        if (r == 1) t0 = bench_now();
+        fir_process_block(&st, input, output_block, NUM_SAMPLES);
+    }
+    t1 = bench_now();
+    bench_report("fir_process_block", t0, t1, (uint64_t)(REPEATS - 1) * NUM_SAMPLES);
+
+    int mismatches = 0;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        mismatches += !same(output_fixed[i], output_dpa[i]);
+        mismatches += !same(output_fixed[i], output_block[i]);
+        mismatches += output_fixed[i].mantissa != output_raw[i];
+    }
+    sink = output_fixed[NUM_SAMPLES - 1].mantissa;
+    printf("%-24s %d mismatches between the four\n", "", mismatches);
+    return mismatches;
+}
+
+int main(void) {
+    int failures = check_ops();
+
+    printf("\n%d-tap FIR, per tap on a mirrored delay line (per output sample)\n", FIR_TAPS);
+    failures += bench_fir();
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
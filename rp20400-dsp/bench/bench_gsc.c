@@ -0,0 +1,154 @@
+/*
+ * Adaptive beamformer (GSC) convergence and cost harness
+ *
+ * A 4-sensor line array looks broadside (90 degrees) at a two-tone target
+ * while two stronger interferers arrive off axis: a broadband one (sum of
+ * random-phase tones, 300 Hz to 1 kHz like the FIR passband) from 30
+ * degrees and a 1.1 kHz tone from 140 degrees, plus independent sensor
+ * noise. The broadband interferer starts at 300 Hz: lower content would need
+ * filters longer than TAPS to cancel. For update intervals of 1, 4 and 16
+ * samples the harness prints the residual (output minus the ideal target)
+ * block by block against the fixed delay-and-sum beam, then times the
+ * canceller per sample. Exits non-zero if any interval fails to gain
+ * MIN_GAIN_DB over the fixed beam once converged.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "gsc.h"
+
+#define SENSORS      4
+#define SPACING_UM   171500
+#define TAPS         16
+#define MU           (dpa_t){50, -3}     // 0.05
+#define EPS          (dpa_t){1, 0}
+#define BLOCKS       200
+#define TAIL_BLOCKS  40                 // blocks averaged for the final gain
+#define BROAD_TONES  40
+#define MIN_GAIN_DB  10.0
+
+#define LATENCY      2                  // beamformer look-ahead (see beamform.c)
+
+static beamformer_t bf;
+static beam_steering_t look;
+static dpa_t channels[BEAM_MAX_SENSORS][BUFFER_SIZE];
+static dpa_t fixed[BUFFER_SIZE], adaptive[BUFFER_SIZE];
+
+static double broad_freq[BROAD_TONES], broad_phase[BROAD_TONES];
+
+static double target(double n) {
+    double t = n / SAMPLE_RATE_HZ;
+    return 200.0 * sin(2.0 * M_PI * 300.0 * t) + 150.0 * sin(2.0 * M_PI * 700.0 * t + 1.0);
+}
+
+static double broadband(double n) {
+    double t = n / SAMPLE_RATE_HZ, v = 0.0;
+    for (int k = 0; k < BROAD_TONES; k++) {
+        v += sin(2.0 * M_PI * broad_freq[k] * t + broad_phase[k]);
+    }
+    return 180.0 * v;   // ~800 counts rms
+}
+
+static double tone(double n) {
+    return 600.0 * sin(2.0 * M_PI * 1100.0 * n / SAMPLE_RATE_HZ);
+}
+
+// Time lead (samples) of sensor s for a plane wave from angle_deg
+static double lead(int s, double angle_deg) {
+    return s * SPACING_UM * 1e-6 * cos(angle_deg * M_PI / 180.0)
+         / (SOUND_SPEED_MM_S / 1000.0) * SAMPLE_RATE_HZ;
+}
+
+static void fill_block(int block, uint32_t *seed) {
+    for (int s = 0; s < SENSORS; s++) {
+        for (int i = 0; i < BUFFER_SIZE; i++) {
+            double n = block * BUFFER_SIZE + i;
+            double v = target(n + lead(s, 90.0)) + broadband(n + lead(s, 30.0))
+                     + tone(n + lead(s, 140.0)) + bench_rand_range(seed, -2, 2);
+            channels[s][i] = (dpa_t){(int32_t)lround(v * 1e4), FIR_INPUT_POINT};
+        }
+    }
+}
+
+static double residual_power(const dpa_t *out, int block, int delay) {
+    double e = 0.0;
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        double n = block * BUFFER_SIZE + i - delay;
+        double r = out[i].mantissa * 1e-4 - target(n + lead(0, 90.0));
+        e += r * r;
+    }
+    return e / BUFFER_SIZE;
+}
+
+static int run_interval(int interval) {
+    static gsc_t g;
+    if (gsc_init(&g, SENSORS, TAPS, MU, EPS, interval, FIR_INPUT_POINT) != 0) {
+        printf("gsc_init failed\n");
+        return 1;
+    }
+    beamformer_reset(&bf);
+
+    uint32_t seed = 0x65C0u;
+    double fixed_tail = 0.0, adaptive_tail = 0.0;
+    printf("update every %2d: residual dB re fixed beam, by block:", interval);
+    for (int b = 0; b < BLOCKS; b++) {
+        fill_block(b, &seed);
+        beamformer_load(&bf, channels, BUFFER_SIZE);
+        beam_form(&bf, &look, fixed);
+        gsc_process(&g, &bf, &look, adaptive);
+
+        double pf = residual_power(fixed, b, LATENCY);
+        double pa = residual_power(adaptive, b, LATENCY + TAPS / 2);
+        if (b % 20 == 0) printf(" %.1f", 10.0 * log10(pa / pf));
+        if (b >= BLOCKS - TAIL_BLOCKS) {
+            fixed_tail += pf;
+            adaptive_tail += pa;
+        }
+    }
+    double gain = 10.0 * log10(fixed_tail / adaptive_tail);
+    printf("\n%-24s converged gain %.1f dB over the fixed beam\n", "", gain);
+
+    // Cost per sample once converged
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < 50; r++) gsc_process(&g, &bf, &look, adaptive);
+    bench_stamp_t t1 = bench_now();
+    char name[32];
+    snprintf(name, sizeof(name), "gsc, update every %d", interval);
+    bench_report(name, t0, t1, 50u * BUFFER_SIZE);
+
+    return gain >= MIN_GAIN_DB ? 0 : 1;
+}
+
+int main(void) {
+    uint32_t seed = 0xB40Au;
+    for (int k = 0; k < BROAD_TONES; k++) {
+        broad_freq[k] = 300.0 + 700.0 * k / BROAD_TONES + bench_rand_range(&seed, 0, 20);
+        broad_phase[k] = 2.0 * M_PI * bench_rand_range(&seed, 0, 999) / 1000.0;
+    }
+
+    beam_sensor_t sensors[SENSORS];
+    for (int s = 0; s < SENSORS; s++) {
+        sensors[s] = (beam_sensor_t){{s * SPACING_UM, -6}, {0, 0}};
+    }
+    if (beamformer_init(&bf, sensors, SENSORS, SAMPLE_RATE_HZ,
+                        (dpa_t){SOUND_SPEED_MM_S, -3}, FIR_INPUT_POINT) != 0 ||
+        beam_steer(&bf, (dpa_t){90, 0}, &look) != 0) {
+        printf("beamformer setup failed\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%d sensors, %d taps per blocking output, mu %.3f\n", SENSORS, TAPS,
+           MU.mantissa * pow(10.0, MU.point));
+    int failures = 0;
+    failures += run_interval(1);
+    failures += run_interval(4);
+    failures += run_interval(16);
+
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < 50; r++) beam_form(&bf, &look, fixed);
+    bench_stamp_t t1 = bench_now();
+    bench_report("fixed beam for scale", t0, t1, 50u * BUFFER_SIZE);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,298 @@
+/*
+ * Batch DPA operations: checks and per-function throughput
+ *
+ * Each of dpa_add_n, dpa_mul_n, dpa_scale_n, dpa_dot_n and dpa_mac_n is
+ * checked on random spans against the scalar primitives or an exact
+ * reference, then timed per element against the same work done with
+ * dpa_add / dpa_multiply on one dpa_t at a time (the dot through a
+ * dpa_acc_t).
+ *
+ * Then every dispatched kernel of each backend this CPU supports is run
+ * on random spans of every length up to SPAN (covering the vector tails)
+ * and must match the scalar kernel bit for bit; the FIR-sized dot products
+ * and the span ops are timed per backend.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "dpa_vec.h"
+#include "dsp.h"
+
+#define SPAN        256
+#define TRIALS      2000
+#define REPEATS     20000
+
+static int32_t a_m[SPAN], b_m[SPAN], out_m[SPAN], acc_m[SPAN];
+static dpa_t   a_d[SPAN], b_d[SPAN], out_d[SPAN];
+
+// Results are stored here so the loops cannot be optimised away
+static volatile int32_t sink;
+
+static void fill(uint32_t *seed, int32_t lo, int32_t hi, int pa, int pb) {
+    for (int i = 0; i < SPAN; i++) {
+        a_m[i] = bench_rand_range(seed, lo, hi);
+        b_m[i] = bench_rand_range(seed, lo, hi);
+        a_d[i] = (dpa_t){a_m[i], (int8_t)pa};
+        b_d[i] = (dpa_t){b_m[i], (int8_t)pb};
+    }
+}
+
+static int check_ops(void) {
+    uint32_t seed = 0xBEEu;
+    int failures = 0;
+
+    for (int t = 0; t < TRIALS; t++) {
+        const int pa = bench_rand_range(&seed, -6, 0), pb = bench_rand_range(&seed, -6, 0);
+        // Small spans are bounded so the coarser one, scaled onto the finer
+        // point, stays within 2^30 and dpa_add cannot overflow
+        const int shift = pa > pb ? pa - pb : pb - pa;
+        const int32_t small = (1 << 30) / dpa_pow10_32[shift] < 30000
+                            ? (1 << 30) / dpa_pow10_32[shift] : 30000;
+        const int32_t range = t & 1 ? 2000000000 : small;
+        fill(&seed, -range, range, pa, pb);
+        dpa_array_t a = dpa_array(a_m, SPAN, pa), b = dpa_array(b_m, SPAN, pb);
+        dpa_array_t out = dpa_array(out_m, 0, 0);
+
+        // add: same as dpa_add element by element
+        if (range < 100000) {
+            dpa_add_n(&a, &b, &out);
+            for (int i = 0; i < SPAN; i++) {
+                dpa_t r = dpa_add(a_d[i], b_d[i]);
+                failures += r.mantissa != out.mantissa[i] || r.point != out.point;
+            }
+        }
+
+        // mul: exact products rounded at the block point, which is the
+        // lowest that holds the largest product
+        dpa_mul_n(&a, &b, &out);
+        int digits = out.point - pa - pb, fits = 1, exact = 1;
+        for (int i = 0; i < SPAN; i++) {
+            int64_t p = (int64_t)a_m[i] * b_m[i];
+            failures += out.mantissa[i] != (int32_t)dpa_round_digits64(p, digits);
+            if (digits > 0 && llabs(dpa_round_digits64(p, digits - 1)) > INT32_MAX) fits = 0;
+            if (llabs(p) > INT32_MAX) exact = 0;
+        }
+        failures += digits > 0 ? fits : !exact;
+
+        // scale: the same as mul by a constant span
+        dpa_t s = b_d[0];
+        for (int i = 0; i < SPAN; i++) acc_m[i] = s.mantissa;
+        dpa_array_t sv = dpa_array(acc_m, SPAN, s.point);
+        dpa_array_t ref = dpa_array(b_m, 0, 0);
+        dpa_mul_n(&a, &sv, &ref);
+        dpa_scale_n(&a, s, &out);
+        failures += out.point != ref.point;
+        for (int i = 0; i < SPAN; i++) failures += out.mantissa[i] != ref.mantissa[i];
+        // dot: the exact sum rounded once (wide spans narrowed so the
+        // sum stays inside int64)
+        const int32_t dot_range = range < 100000 ? range : 100000000;
+        fill(&seed, -dot_range, dot_range, pa, pb);
+        dpa_t d = dpa_dot_n(&a, &b);
+        __int128 sum = 0;
+        for (int i = 0; i < SPAN; i++) sum += (__int128)a_m[i] * b_m[i];
+        int dd = d.point - pa - pb;
+        __int128 scale = dpa_pow10_64[dd], q = sum / scale, r = sum % scale;
+        if (2 * (r < 0 ? -r : r) >= scale) q += sum < 0 ? -1 : 1;
+        failures += d.mantissa != (int32_t)q;
+
+        // mac: acc += c * x matches dpa_add(acc, dpa_multiply(c, x)) while
+        // the products fit
+        if (range < 100000) {
+            dpa_t c = {bench_rand_range(&seed, -999, 999), -3};
+            const int acc_point = pa + c.point;
+            for (int i = 0; i < SPAN; i++) acc_m[i] = b_m[i];
+            dpa_array_t acc = dpa_array(acc_m, SPAN, acc_point);
+            dpa_mac_n(&acc, &a, c);
+            for (int i = 0; i < SPAN; i++) {
+                dpa_t e = dpa_add((dpa_t){b_m[i], (int8_t)acc_point}, dpa_multiply(c, a_d[i]));
+                failures += e.mantissa != acc_m[i] || e.point != acc_point;
+            }
+            // Products too far above acc's point are rejected
+            acc.point = (int8_t)(acc_point - DPA_POW10_32_MAX - 1);
+            failures += dpa_mac_n(&acc, &a, c) != -1;
+        }
+    }
+
+    printf("dpa_*_n: %d trials of %d elements, %d wrong\n", TRIALS, SPAN, failures);
+    return failures;
+}
+
+// Time one batch call and the scalar loop doing the same, per element
+// (the results are summed unsigned, so the sum wraps instead of overflowing)
+#define BENCH_PAIR(name, batch, scalar)                                         \
+    do {                                                                        \
+        uint32_t acc = 0;                                                       \
+        bench_stamp_t t0 = bench_now();                                         \
+        for (int r = 0; r < REPEATS; r++) { batch; }                            \
+        bench_stamp_t t1 = bench_now();                                         \
+        bench_report(name "_n", t0, t1, (uint64_t)REPEATS * SPAN);              \
+        t0 = bench_now();                                                       \
+        for (int r = 0; r < REPEATS; r++) {                                     \
+            for (int i = 0; i < SPAN; i++) { scalar; }                          \
+        }                                                                       \
+        t1 = bench_now();                                                       \
+        bench_report("  scalar", t0, t1, (uint64_t)REPEATS * SPAN);             \
+        sink = (int32_t)acc;                                                    \
+    } while (0)
+
+static void bench_ops(void) {
+    uint32_t seed = 0x5EEu;
+    fill(&seed, -30000, 30000, -4, -6);
+    dpa_array_t a = dpa_array(a_m, SPAN, -4), b = dpa_array(b_m, SPAN, -6);
+    dpa_array_t out = dpa_array(out_m, SPAN, 0);
+    dpa_array_t acc_v = dpa_array(acc_m, SPAN, -7);
+    // Alternating signs keep the accumulators bounded over the repeats
+    const dpa_t c[2] = {{123, -3}, {-123, -3}};
+
+    BENCH_PAIR("dpa_add",
+               dpa_add_n(&a, &b, &out); acc += out.mantissa[r & (SPAN - 1)],
+               out_d[i] = dpa_add(a_d[i], b_d[i]); acc += out_d[i].mantissa);
+    BENCH_PAIR("dpa_mul",
+               dpa_mul_n(&a, &b, &out); acc += out.mantissa[r & (SPAN - 1)],
+               out_d[i] = dpa_multiply(a_d[i], b_d[i]); acc += out_d[i].mantissa);
+    BENCH_PAIR("dpa_scale",
+               dpa_scale_n(&a, c[r & 1], &out); acc += out.mantissa[r & (SPAN - 1)],
+               out_d[i] = dpa_multiply(a_d[i], c[r & 1]); acc += out_d[i].mantissa);
+    // The scalar dot sums into a wide accumulator too: a dpa_add chain
+    // overflows its int32 mantissa within a few dozen products
+    dpa_acc_t dot = dpa_acc(-10);
+    BENCH_PAIR("dpa_dot",
+               acc += dpa_dot_n(&a, &b).mantissa,
+               if (i == 0) dot = dpa_acc(-10);
+               dpa_acc_mac(&dot, a_d[i], b_d[i]);
+               if (i == SPAN - 1) acc += dpa_acc_round(dot).mantissa);
+    // Both accumulators start from zero at the products' point
+    for (int i = 0; i < SPAN; i++) {
+        acc_m[i] = 0;
+        out_d[i] = (dpa_t){0, -7};
+    }
+    BENCH_PAIR("dpa_mac",
+               dpa_mac_n(&acc_v, &a, c[r & 1]); acc += acc_v.mantissa[r & (SPAN - 1)],
+               out_d[i] = dpa_add(out_d[i], dpa_multiply(c[r & 1], a_d[i])); acc += out_d[i].mantissa);
+}
+
+static const char *const backend_names[] = {"scalar", "sse4.1", "avx2"};
+
+// Every kernel of the selected backend against the scalar kernels
+static int check_backend(void) {
+    static int32_t ref[SPAN], got[SPAN];
+    uint32_t seed = 0xD15u;
+    int failures = 0;
+
+    for (int n = 0; n <= SPAN; n++) {
+        // Full-range values, or ones small enough that int32 products and
+        // sums are exact (the contract for add_scaled / mul / scale)
+        for (int wide = 0; wide < 2; wide++) {
+            const int32_t range = wide ? INT32_MAX : 30000;
+            for (int i = 0; i < SPAN; i++) {
+                a_m[i] = bench_rand_range(&seed, -range, range);
+                b_m[i] = bench_rand_range(&seed, -range, range);
+            }
+            if (wide) a_m[bench_rand_range(&seed, 0, SPAN - 1)] = INT32_MIN;
+            const int32_t c = b_m[0];
+
+            failures += dpa_vec_peak_product(a_m, b_m, n) != dpa_peak_product_i32(a_m, b_m, n);
+            failures += dpa_vec_peak(a_m, n) != dpa_peak_i32(a_m, n);
+
+            // Full-range products only fit int32 with all their digits
+            // dropped; small ones are exact
+            const int digits = wide ? DPA_MUL_MAX_SHIFT : 0;
+            dpa_mul_i32(ref, a_m, b_m, digits, n);
+            dpa_vec_mul(got, a_m, b_m, digits, n);
+            failures += memcmp(ref, got, n * sizeof(int32_t)) != 0;
+            dpa_scale_i32(ref, a_m, c, digits, n);
+            dpa_vec_scale(got, a_m, c, digits, n);
+            failures += memcmp(ref, got, n * sizeof(int32_t)) != 0;
+            if (!wide) {
+                dpa_add_scaled_i32(ref, a_m, b_m, 1000, n);
+                dpa_vec_add_scaled(got, a_m, b_m, 1000, n);
+                failures += memcmp(ref, got, n * sizeof(int32_t)) != 0;
+            }
+
+            // Dots: wide coefficients narrowed to 2^23 so SPAN products
+            // of a full-range sample sum inside int64; folds keep
+            // x[i] +- x[taps - 1 - i] inside int32, as the FIR does
+            if (wide) {
+                for (int i = 0; i < SPAN; i++) b_m[i] >>= 8;
+            }
+            int32_t *fold = wide ? acc_m : a_m;
+            for (int i = 0; i < SPAN; i++) acc_m[i] = a_m[i] / 2;
+            failures += dpa_vec_dot(a_m, b_m, n) != dpa_dot_i32(a_m, b_m, n);
+            failures += dpa_vec_dot_sym(b_m, fold, n) != dpa_dot_sym_i32(b_m, fold, n);
+            failures += dpa_vec_dot_antisym(b_m, fold, n) != dpa_dot_antisym_i32(b_m, fold, n);
+        }
+    }
+    return failures;
+}
+
+static void bench_backend(void) {
+    uint32_t seed = 0x7A9u;
+    for (int i = 0; i < SPAN; i++) {
+        a_m[i] = bench_rand_range(&seed, -(1 << 30), 1 << 30);
+        b_m[i] = bench_rand_range(&seed, -(1 << 23), 1 << 23);
+    }
+    uint64_t acc = 0;   // summed unsigned, so it wraps instead of overflowing
+
+    // The FIR's per-output kernels at the pipeline's tap count, per tap
+    bench_stamp_t t0 = bench_now();
+    for (int r = 0; r < REPEATS * 8; r++) acc += (uint64_t)dpa_vec_dot(b_m, a_m + (r & 63), FIR_TAPS);
+    bench_stamp_t t1 = bench_now();
+    bench_report("  dot, FIR_TAPS", t0, t1, (uint64_t)REPEATS * 8 * FIR_TAPS);
+
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS * 8; r++) acc += (uint64_t)dpa_vec_dot_sym(b_m, a_m + (r & 63), 63);
+    t1 = bench_now();
+    bench_report("  dot_sym, 63 taps", t0, t1, (uint64_t)REPEATS * 8 * 63);
+
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) acc += (uint64_t)dpa_vec_dot(a_m, b_m, SPAN);
+    t1 = bench_now();
+    bench_report("  dot, span", t0, t1, (uint64_t)REPEATS * SPAN);
+
+    // The coarser span is b, scaled up by 100 onto a's point: 2^30 + 2^23 * 100
+    // still fits int32
+    dpa_array_t a = dpa_array(a_m, SPAN, -6), b = dpa_array(b_m, SPAN, -4);
+    dpa_array_t out = dpa_array(out_m, SPAN, 0);
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) dpa_add_n(&a, &b, &out);
+    t1 = bench_now();
+    bench_report("  dpa_add_n", t0, t1, (uint64_t)REPEATS * SPAN);
+
+    for (int i = 0; i < SPAN; i++) a_m[i] >>= 16;
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) dpa_mul_n(&a, &b, &out);
+    t1 = bench_now();
+    bench_report("  dpa_mul_n, rounded", t0, t1, (uint64_t)REPEATS * SPAN);
+
+    for (int i = 0; i < SPAN; i++) b_m[i] >>= 12;
+    t0 = bench_now();
+    for (int r = 0; r < REPEATS; r++) dpa_mul_n(&a, &b, &out);
+    t1 = bench_now();
+    bench_report("  dpa_mul_n, exact", t0, t1, (uint64_t)REPEATS * SPAN);
+
+    sink = (int32_t)acc + out.mantissa[0];
+}
+
+int main(void) {
+    int failures = check_ops();
+
+    printf("\nBatch vs scalar (per element, spans of %d)\n", SPAN);
+    bench_ops();
+
+    const dpa_vec_backend_t selected = dpa_vec_backend();
+    printf("\nBackends (selected at startup: %s)\n", backend_names[selected]);
+    for (int k = DPA_VEC_SCALAR; k <= DPA_VEC_AVX2; k++) {
+        if (dpa_vec_select((dpa_vec_backend_t)k) != 0) {
+            printf("%s: not available\n", backend_names[k]);
+            continue;
+        }
+        int wrong = check_backend();
+        printf("%s: %d mismatches vs scalar over lengths 0..%d\n", backend_names[k], wrong, SPAN);
+        failures += wrong;
+        bench_backend();
+    }
+    dpa_vec_select(selected);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/*
+ * Detached Point Arithmetic (DPA) core - lookup tables
+ */
+
+#include "dpa.h"
+
+// Table lookups replace the per-call `scale *= 10` loops; on the M0+ a
+// load is a couple of cycles where the loop cost one multiply per digit.
+const int32_t dpa_pow10_32[DPA_POW10_32_MAX + 1] = {
+    1,
+    10,
+    100,
+    1000,
+    10000,
+    100000,
+    1000000,
+    10000000,
+    100000000,
+    1000000000
+};
+
+const int64_t dpa_pow10_64[DPA_POW10_64_MAX + 1] = {
+    1LL,
+    10LL,
+    100LL,
+    1000LL,
+    10000LL,
+    100000LL,
+    1000000LL,
+    10000000LL,
+    100000000LL,
+    1000000000LL,
+    10000000000LL,
+    100000000000LL,
+    1000000000000LL,
+    10000000000000LL,
+    100000000000000LL,
+    1000000000000000LL,
+    10000000000000000LL,
+    100000000000000000LL,
+    1000000000000000000LL
+};
+
+// (INT32_MAX + 1) * 10^d - 10^d / 2 - 1: one more and rounding would carry
+// past INT32_MAX. The last entry only needs to cover |int32 * int32|.
+const int64_t dpa_round_limit[DPA_MUL_MAX_SHIFT + 1] = {
+    2147483647LL,
+    21474836474LL,
+    214748364749LL,
+    2147483647499LL,
+    21474836474999LL,
+    214748364749999LL,
+    2147483647499999LL,
+    21474836474999999LL,
+    214748364749999999LL,
+    2147483647499999999LL,
+    INT64_MAX
+};
@@ -0,0 +1,233 @@
+/*
+ * Detached Point Arithmetic (DPA) core
+ *
+ * A dpa_t is an integer mantissa with a detached decimal point:
+ *     value = mantissa * 10^point
+ *
+ * Header-only so the primitives inline into the DSP loops on the RP2040,
+ * and free of any Pico SDK dependency so the same code builds on the host.
+ */
+
+#ifndef DPA_H
+#define DPA_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// DPA CORE IMPLEMENTATION (for microcontroller)
+// ============================================================================
+
+typedef struct {
+    int32_t mantissa;   // 32-bit for microcontroller efficiency
+    int8_t  point;      // Decimal point position
+} dpa_t;
+
+// Powers of ten for point alignment, indexed by exponent (defined in dpa.c)
+#define DPA_POW10_32_MAX    9   // 10^9 is the largest power that fits int32
+#define DPA_POW10_64_MAX    18  // 10^18 is the largest power that fits int64
+
+extern const int32_t dpa_pow10_32[DPA_POW10_32_MAX + 1];
+extern const int64_t dpa_pow10_64[DPA_POW10_64_MAX + 1];
+
+// Drop `digits` decimal digits from a wide mantissa, rounding half away
+// from zero. digits must be in [0, DPA_POW10_64_MAX].
+static inline int64_t dpa_round_digits64(int64_t value, int digits) {
+    if (digits <= 0) return value;
+    int64_t scale = dpa_pow10_64[digits];
+    int64_t half = scale / 2;
+    // Division truncates toward zero, so biasing by +-half rounds away
+    return (value + (value < 0 ? -half : half)) / scale;
+}
+
+// Basic DPA operations optimized for RP2040
+//
+// dpa_add aligns to the finer (more negative) point by scaling the coarser
+// operand up, so no digits are lost. A zero operand adopts the other
+// operand's point, which lets accumulators start from {0, 0}. When the
+// point difference is too large to scale, the finer operand is below the
+// coarser one's resolution and is dropped.
+static inline dpa_t dpa_add(dpa_t a, dpa_t b) {
+    if (a.point == b.point) {
+        return (dpa_t){a.mantissa + b.mantissa, a.point};
+    }
+    
+    if (a.point > b.point) {
+        if (a.mantissa == 0) return b;
+        int shift = a.point - b.point;
+        if (shift > DPA_POW10_32_MAX) return a; // Avoid overflow
+        return (dpa_t){a.mantissa * dpa_pow10_32[shift] + b.mantissa, b.point};
+    } else {
+        if (b.mantissa == 0) return a;
+        int shift = b.point - a.point;
+        if (shift > DPA_POW10_32_MAX) return b;
+        return (dpa_t){a.mantissa + b.mantissa * dpa_pow10_32[shift], a.point};
+    }
+}
+
+// Status bits dpa_multiply_flags ORs into *flags (sticky, like fenv)
+#define DPA_INEXACT         0x1     // digits were rounded off the result
+#define DPA_SATURATED       0x2     // result clamped to +-INT32_MAX at point 127
+
+// dpa_round_limit[d]: largest |product| that still fits int32 after
+// dropping d digits with rounding (defined in dpa.c)
+#define DPA_MUL_MAX_SHIFT   10      // |int32 * int32| <= 2^62 needs at most 10
+extern const int64_t dpa_round_limit[DPA_MUL_MAX_SHIFT + 1];
+
+// Digits to drop from a product of magnitude mag > INT32_MAX so it fits
+// int32 after rounding. The bit length gives a lower bound on the digit
+// count (floor((bits - 32) * log10 2), with 1233/4096 ~ log10 2); one or
+// two table compares finish the job.
+static inline int dpa_product_shift(uint64_t mag) {
+    int bits = 64 - __builtin_clzll(mag);
+    int d = ((bits - 32) * 1233) >> 12;
+    while ((int64_t)mag > dpa_round_limit[d]) d++;
+    return d;
+}
+
+// value * 10^point as a dpa_t, normalised only as far as needed: when
+// |value| exceeds INT32_MAX the fewest decimal digits are dropped, rounding
+// half away from zero (|value| must stay below 2^63). The mantissa range is
+// symmetric, +-INT32_MAX as for saturation, so INT32_MIN itself is
+// normalised (and flagged inexact) and every result can be negated. A
+// result point beyond int8 saturates (too large) or rounds further toward
+// zero (too small). Status bits are ORed into *flags.
+static inline dpa_t dpa_normalise64_flags(int64_t value, int point, unsigned *flags) {
+    // One unsigned compare for |value| > INT32_MAX, INT32_MIN included
+    if ((uint64_t)value + INT32_MAX > 2u * (uint64_t)INT32_MAX) {
+        uint64_t mag = value < 0 ? -(uint64_t)value : (uint64_t)value;
+        int d = dpa_product_shift(mag);
+        value = dpa_round_digits64(value, d);
+        point += d;
+        *flags |= DPA_INEXACT;
+    }
+    
+    if (point > INT8_MAX) {
+        *flags |= DPA_SATURATED;
+        return (dpa_t){value < 0 ? -INT32_MAX : INT32_MAX, INT8_MAX};
+    }
+    if (point < INT8_MIN) {
+        int d = INT8_MIN - point;
+        value = d > DPA_POW10_64_MAX ? 0 : dpa_round_digits64(value, d);
+        point = INT8_MIN;
+        *flags |= DPA_INEXACT;
+    }
+    
+    return (dpa_t){(int32_t)value, (int8_t)point};
+}
+
+// Exact product, normalised like dpa_normalise64_flags
+static inline dpa_t dpa_multiply_flags(dpa_t a, dpa_t b, unsigned *flags) {
+    return dpa_normalise64_flags((int64_t)a.mantissa * b.mantissa, a.point + b.point, flags);
+}
+
+static inline dpa_t dpa_multiply(dpa_t a, dpa_t b) {
+    unsigned flags = 0;
+    return dpa_multiply_flags(a, b, &flags);
+}
+
+// decimal_places must be in [0, DPA_POW10_32_MAX]
+static inline dpa_t dpa_from_int(int32_t value, int decimal_places) {
+    return (dpa_t){value * dpa_pow10_32[decimal_places], (int8_t)-decimal_places};
+}
+
+// Value of a mantissa scaled up by more than DPA_POW10_32_MAX digits: only
+// zero stays in range, anything else saturates like dpa_multiply
+static inline int32_t dpa_saturate32(int32_t mantissa) {
+    return mantissa == 0 ? 0 : mantissa < 0 ? -INT32_MAX : INT32_MAX;
+}
+
+static inline int32_t dpa_to_int(dpa_t num) {
+    if (num.point >= 0) {
+        if (num.point > DPA_POW10_32_MAX) return dpa_saturate32(num.mantissa);
+        return num.mantissa * dpa_pow10_32[num.point];
+    } else {
+        if (-num.point > DPA_POW10_32_MAX) return 0; // |mantissa| < 10^10
+        return num.mantissa / dpa_pow10_32[-num.point];
+    }
+}
+
+// Mantissa of num re-expressed at the given point (truncates like dpa_to_int).
+// Used to bring a value onto a block's fixed exponent.
+static inline int32_t dpa_mantissa_at(dpa_t num, int point) {
+    int shift = num.point - point;
+    if (shift >= 0) {
+        if (shift > DPA_POW10_32_MAX) return dpa_saturate32(num.mantissa);
+        return num.mantissa * dpa_pow10_32[shift];
+    } else {
+        if (-shift > DPA_POW10_32_MAX) return 0;
+        return num.mantissa / dpa_pow10_32[-shift];
+    }
+}
+
+// As dpa_mantissa_at, but a value finer than point is rounded half away
+// from zero rather than truncated
+static inline int32_t dpa_mantissa_round_at(dpa_t num, int point) {
+    int shift = num.point - point;
+    if (shift >= 0) return dpa_mantissa_at(num, point);
+    return -shift > DPA_POW10_64_MAX ? 0 : (int32_t)dpa_round_digits64(num.mantissa, -shift);
+}
+
+// ============================================================================
+// WIDE ACCUMULATOR
+// ============================================================================
+//
+// A running sum with an int64 mantissa at one fixed point. Products of two
+// dpa_t (at most 2^62) add in exactly, so a reduction (dot product, filter
+// tap sum, energy) accumulates with no per-term normalisation and rounds
+// once, with dpa_acc_round, when the result is stored. Summing into a
+// dpa_t with dpa_add instead overflows the int32 mantissa within a few
+// dozen products.
+//
+// Choose the point as the finest one the terms arrive at (usually
+// a.point + b.point of the products): terms at or above it are scaled up
+// exactly, terms below it are rounded to it. The caller keeps the sum
+// below 2^63 in magnitude.
+
+typedef struct {
+    int64_t mantissa;
+    int8_t  point;
+} dpa_acc_t;
+
+// An empty accumulator at the given point
+static inline dpa_acc_t dpa_acc(int point) {
+    return (dpa_acc_t){0, (int8_t)point};
+}
+
+// m * 10^point brought to the accumulator's point
+static inline int64_t dpa_acc_align(const dpa_acc_t *acc, int64_t m, int point) {
+    int shift = point - acc->point;
+    if (shift >= 0) return shift > DPA_POW10_64_MAX ? 0 : m * dpa_pow10_64[shift];
+    return -shift > DPA_POW10_64_MAX ? 0 : dpa_round_digits64(m, -shift);
+}
+
+// acc += x
+static inline void dpa_acc_add(dpa_acc_t *acc, dpa_t x) {
+    acc->mantissa += dpa_acc_align(acc, x.mantissa, x.point);
+}
+
+// acc += a * b, the product kept exact
+static inline void dpa_acc_mac(dpa_acc_t *acc, dpa_t a, dpa_t b) {
+    const int point = a.point + b.point;
+    const int64_t product = (int64_t)a.mantissa * b.mantissa;
+    acc->mantissa += point == acc->point ? product : dpa_acc_align(acc, product, point);
+}
+
+// The sum as a dpa_t, rounded once like dpa_multiply
+static inline dpa_t dpa_acc_round_flags(dpa_acc_t acc, unsigned *flags) {
+    return dpa_normalise64_flags(acc.mantissa, acc.point, flags);
+}
+
+static inline dpa_t dpa_acc_round(dpa_acc_t acc) {
+    unsigned flags = 0;
+    return dpa_acc_round_flags(acc, &flags);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DPA_H
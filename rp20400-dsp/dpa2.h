@@ -0,0 +1,175 @@
+/*
+ * Binary-exponent DPA
+ *
+ * A dpa2_t is an integer mantissa with a detached binary point:
+ *     value = mantissa * 2^point
+ *
+ * Same API surface as dpa_t (add, multiply, from_int, to_int), but every
+ * alignment is a shift and every normalisation a rounding shift, where
+ * dpa_t needs multiplies and divisions by powers of ten. The M0+ has no
+ * divider in the core, so this is the cheaper mode when a value does not
+ * have to keep an exact decimal representation.
+ *
+ * Header-only like dpa.h, and free of any Pico SDK dependency.
+ */
+
+#ifndef DPA2_H
+#define DPA2_H
+
+#include "dpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int32_t mantissa;
+    int8_t  point;      // Binary point position
+} dpa2_t;
+
+// Arithmetic a DSP stage normalises in: powers of ten or powers of two
+typedef enum {
+    DPA_DECIMAL,
+    DPA_BINARY
+} dpa_mode_t;
+
+// Largest shift that scales an int32 mantissa without touching the sign bit
+#define DPA2_SHIFT_32_MAX   30
+
+// m * 2^shift for shift in [0, DPA2_SHIFT_32_MAX], without the undefined
+// behaviour of left-shifting a negative value
+static inline int32_t dpa2_scale32(int32_t m, int shift) {
+    return (int32_t)((uint32_t)m << shift);
+}
+
+// Drop `bits` bits from a wide mantissa, rounding half away from zero.
+// bits must be in [0, 62]. Branch-free: the -1 for negative values turns
+// the floor of the arithmetic shift into rounding away on ties.
+static inline int64_t dpa2_round_bits64(int64_t value, int bits) {
+    if (bits <= 0) return value;
+    int64_t half = (int64_t)1 << (bits - 1);
+    return (value + half - (value < 0)) >> bits;
+}
+
+// Same contract as dpa_add: aligns to the finer point by scaling the
+// coarser operand up, a zero operand adopts the other's point, and an
+// operand below the other's resolution is dropped
+static inline dpa2_t dpa2_add(dpa2_t a, dpa2_t b) {
+    if (a.point == b.point) {
+        return (dpa2_t){a.mantissa + b.mantissa, a.point};
+    }
+
+    if (a.point > b.point) {
+        if (a.mantissa == 0) return b;
+        int shift = a.point - b.point;
+        if (shift > DPA2_SHIFT_32_MAX) return a;
+        return (dpa2_t){dpa2_scale32(a.mantissa, shift) + b.mantissa, b.point};
+    } else {
+        if (b.mantissa == 0) return a;
+        int shift = b.point - a.point;
+        if (shift > DPA2_SHIFT_32_MAX) return b;
+        return (dpa2_t){a.mantissa + dpa2_scale32(b.mantissa, shift), a.point};
+    }
+}
+
+// Same contract as dpa_multiply_flags: exact product, normalised by the
+// fewest bits that make it fit int32 (rounding half away from zero), with
+// the same saturation and DPA_INEXACT / DPA_SATURATED flags. The bit count
+// comes straight from the leading-zero count, no table needed.
+static inline dpa2_t dpa2_multiply_flags(dpa2_t a, dpa2_t b, unsigned *flags) {
+    int64_t product = (int64_t)a.mantissa * b.mantissa;
+    int point = a.point + b.point;
+
+    if ((uint64_t)(product + INT32_MAX) > 2u * (uint64_t)INT32_MAX) {
+        uint64_t mag = product < 0 ? -(uint64_t)product : (uint64_t)product;
+        int d = 64 - __builtin_clzll(mag) - 31;
+        // Rounding up can carry into bit 31; one more bit then fits
+        int64_t rounded = dpa2_round_bits64(product, d);
+        if (rounded > INT32_MAX || rounded < -INT32_MAX) {
+            rounded = dpa2_round_bits64(product, ++d);
+        }
+        product = rounded;
+        point += d;
+        *flags |= DPA_INEXACT;
+    }
+
+    if (point > INT8_MAX) {
+        *flags |= DPA_SATURATED;
+        return (dpa2_t){product < 0 ? -INT32_MAX : INT32_MAX, INT8_MAX};
+    }
+    if (point < INT8_MIN) {
+        int d = INT8_MIN - point;
+        product = d > 62 ? 0 : dpa2_round_bits64(product, d);
+        point = INT8_MIN;
+        *flags |= DPA_INEXACT;
+    }
+
+    return (dpa2_t){(int32_t)product, (int8_t)point};
+}
+
+static inline dpa2_t dpa2_multiply(dpa2_t a, dpa2_t b) {
+    unsigned flags = 0;
+    return dpa2_multiply_flags(a, b, &flags);
+}
+
+// fraction_bits must be in [0, DPA2_SHIFT_32_MAX]
+static inline dpa2_t dpa2_from_int(int32_t value, int fraction_bits) {
+    return (dpa2_t){dpa2_scale32(value, fraction_bits), (int8_t)-fraction_bits};
+}
+
+// m * 2^shift for any shift, truncating toward zero when shift < 0:
+// negative values are biased by 2^-shift - 1 so the arithmetic shift does
+// not floor them
+static inline int32_t dpa2_shift32(int32_t m, int shift) {
+    if (shift >= 0) return dpa2_scale32(m, shift);
+    shift = -shift;
+    if (shift > 31) return 0;
+    int32_t bias = (m >> 31) & (int32_t)((1u << shift) - 1);
+    return (m + bias) >> shift;
+}
+
+// Truncates toward zero like dpa_to_int
+static inline int32_t dpa2_to_int(dpa2_t num) {
+    return dpa2_shift32(num.mantissa, num.point);
+}
+
+// Mantissa of num re-expressed at the given binary point (truncates like
+// dpa2_to_int)
+static inline int32_t dpa2_mantissa_at(dpa2_t num, int point) {
+    return dpa2_shift32(num.mantissa, num.point - point);
+}
+
+// Conversions between the two modes, rounded half away from zero. The
+// result must fit int32; decimal points must be in [-9, 9] and binary
+// points in [-31, 31].
+static inline dpa2_t dpa2_from_dpa(dpa_t x, int point) {
+    int64_t num = x.mantissa;
+    int64_t den = 1;
+
+    if (x.point >= 0) num *= dpa_pow10_32[x.point];
+    else              den = dpa_pow10_32[-x.point];
+    if (point <= 0)   num *= (int64_t)1 << -point;
+    else              den <<= point;
+
+    int64_t half = den / 2;
+    return (dpa2_t){(int32_t)((num + (num < 0 ? -half : half)) / den), (int8_t)point};
+}
+
+static inline dpa_t dpa_from_dpa2(dpa2_t x, int point) {
+    int64_t num = x.mantissa;
+    int64_t den = 1;
+
+    if (x.point >= 0) num *= (int64_t)1 << x.point;
+    else              den = (int64_t)1 << -x.point;
+    if (point <= 0)   num *= dpa_pow10_32[-point];
+    else              den *= dpa_pow10_32[point];
+
+    int64_t half = den / 2;
+    return (dpa_t){(int32_t)((num + (num < 0 ? -half : half)) / den), (int8_t)point};
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DPA2_H
@@ -0,0 +1,80 @@
+/*
+ * Shared-exponent DPA arrays
+ */
+
+#include <string.h>
+#include "dpa_array.h"
+
+// Decimal digits |m| can be scaled up by and still fit int32 (m != 0)
+static int dpa_headroom(int32_t m) {
+    int64_t mag = m < 0 ? -(int64_t)m : m;
+    int d = 0;
+    while (d < DPA_POW10_32_MAX && mag * dpa_pow10_32[d + 1] <= INT32_MAX) d++;
+    return d;
+}
+
+int dpa_array_common_point(const dpa_t *values, int n) {
+    int finest = INT8_MAX;
+    int limit = INT8_MIN;       // no value may be scaled past its headroom
+
+    for (int i = 0; i < n; i++) {
+        if (values[i].mantissa == 0) continue;
+        int p = values[i].point;
+        if (p < finest) finest = p;
+        int lowest = p - dpa_headroom(values[i].mantissa);
+        if (lowest > limit) limit = lowest;
+    }
+
+    if (finest == INT8_MAX) return 0;
+    return finest > limit ? finest : limit;
+}
+
+void dpa_array_from_dpa(dpa_array_t *dst, const dpa_t *src, int n) {
+    const int point = dpa_array_common_point(src, n);
+
+    // The point leaves every non-zero value room to scale up; zeros may
+    // sit any distance above it, which dpa_mantissa_round_at bounds
+    for (int i = 0; i < n; i++) {
+        dst->mantissa[i] = dpa_mantissa_round_at(src[i], point);
+    }
+    dst->length = n;
+    dst->point = (int8_t)point;
+}
+
+void dpa_array_to_dpa(const dpa_array_t *src, dpa_t *dst) {
+    for (int i = 0; i < src->length; i++) {
+        dst[i] = (dpa_t){src->mantissa[i], src->point};
+    }
+}
+
+void dpa_array_rescale(dpa_array_t *a, int point) {
+    int shift = a->point - point;
+
+    if (shift > DPA_POW10_32_MAX) {
+        for (int i = 0; i < a->length; i++) a->mantissa[i] = dpa_saturate32(a->mantissa[i]);
+    } else if (shift > 0) {
+        const int32_t scale = dpa_pow10_32[shift];
+        for (int i = 0; i < a->length; i++) a->mantissa[i] *= scale;
+    } else if (shift < 0) {
+        if (-shift > DPA_POW10_64_MAX) {
+            memset(a->mantissa, 0, a->length * sizeof(int32_t));
+        } else {
+            for (int i = 0; i < a->length; i++) {
+                a->mantissa[i] = (int32_t)dpa_round_digits64(a->mantissa[i], -shift);
+            }
+        }
+    }
+    a->point = (int8_t)point;
+}
+
+void dpa_array_copy_at(const dpa_array_t *src, int start, int n, int point, int32_t *dst) {
+    const int32_t *m = src->mantissa + start;
+
+    if (src->point == point) {
+        memmove(dst, m, n * sizeof(int32_t));
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        dst[i] = dpa_mantissa_at((dpa_t){m[i], src->point}, point);
+    }
+}
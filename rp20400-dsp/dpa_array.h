@@ -0,0 +1,67 @@
+/*
+ * Shared-exponent DPA arrays
+ *
+ * A dpa_array_t is a view of contiguous int32 mantissas that share one
+ * decimal point:
+ *     value[i] = mantissa[i] * 10^point
+ *
+ * An array of dpa_t spends 8 bytes per element (mantissa, point, padding)
+ * repeating the same point; the mantissas alone take half that, and
+ * kernels stream them as plain integers. The view does not own its
+ * storage, so buffers stay static or on the stack as before.
+ */
+
+#ifndef DPA_ARRAY_H
+#define DPA_ARRAY_H
+
+#include "dpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int32_t *mantissa;
+    int      length;
+    int8_t   point;
+} dpa_array_t;
+
+static inline dpa_array_t dpa_array(int32_t *mantissa, int length, int point) {
+    return (dpa_array_t){mantissa, length, (int8_t)point};
+}
+
+static inline dpa_t dpa_array_get(const dpa_array_t *a, int i) {
+    return (dpa_t){a->mantissa[i], a->point};
+}
+
+// Store value at the array's point (truncates like dpa_mantissa_at)
+static inline void dpa_array_set(dpa_array_t *a, int i, dpa_t value) {
+    a->mantissa[i] = dpa_mantissa_at(value, a->point);
+}
+
+// Finest point at which every value fits an int32 mantissa, so a block
+// conversion loses nothing unless the values span more than int32 can
+// hold. Zeros fit anywhere; an all-zero input gives point 0.
+int dpa_array_common_point(const dpa_t *values, int n);
+
+// Convert n values to dst (which must hold n mantissas) at their common
+// point. Values finer than that point are rounded half away from zero.
+void dpa_array_from_dpa(dpa_array_t *dst, const dpa_t *src, int n);
+
+// Expand to one dpa_t per element
+void dpa_array_to_dpa(const dpa_array_t *src, dpa_t *dst);
+
+// Move the whole array to another point: coarser rounds half away from
+// zero, finer scales up (the caller makes sure the mantissas still fit;
+// more than DPA_POW10_32_MAX digits up saturates every non-zero one)
+void dpa_array_rescale(dpa_array_t *a, int point);
+
+// Mantissas src[start .. start + n - 1] re-expressed at `point` into dst
+// (truncating like dpa_mantissa_at); a plain copy when the points match
+void dpa_array_copy_at(const dpa_array_t *src, int start, int n, int point, int32_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DPA_ARRAY_H
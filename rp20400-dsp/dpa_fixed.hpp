@@ -0,0 +1,178 @@
+/*
+ * Compile-time-point DPA for C++
+ *
+ * A dpa_fixed<Point> is an int32 mantissa whose decimal point is part of
+ * the type:
+ *     value = mantissa * 10^Point
+ *
+ * Sums, products and rescales work out the result point at compile time,
+ * so there is no point field, no alignment branch and no power-of-ten table
+ * lookup left in the generated code: a sum is an add (the coarser operand
+ * times a constant), a product is one 32 x 32 -> 64 multiply and a
+ * rescale divides by a constant, which compiles to a multiply. This is the
+ * arithmetic the C kernels write out by hand on bare mantissas (fir.c,
+ * beamform.c), checked by the type system instead of by comments.
+ *
+ *     dpa_fixed<P> +- dpa_fixed<Q>  ->  dpa_fixed<min(P, Q)>
+ *     dpa_fixed<P> *  dpa_fixed<Q>  ->  dpa_fixed_acc<P + Q>   (exact, int64)
+ *     dpa_fixed_acc<P> += ...       ->  multiply-accumulate, exact
+ *     x.rescale<Q>(), acc.round<Q>()    exact scale up / round half away
+ *                                       from zero, as dpa_round_digits64
+ *
+ * As with dpa_add and dpa_acc_t, the caller keeps mantissas inside int32
+ * and sums inside int64; nothing saturates. dpa_t and dpa_acc_t convert in
+ * both directions, so values can cross into the C API at any point.
+ *
+ * Header-only, C++14.
+ */
+
+#ifndef DPA_FIXED_HPP
+#define DPA_FIXED_HPP
+
+#include <cstdint>
+#include "dpa.h"
+
+namespace dpa_fixed_detail {
+
+constexpr int64_t pow10(int n) {
+    int64_t r = 1;
+    for (int i = 0; i < n; i++) r *= 10;
+    return r;
+}
+
+constexpr int min_point(int a, int b) {
+    return a < b ? a : b;
+}
+
+// m * 10^From re-expressed at 10^To: scaled up exactly, or rounded half
+// away from zero like dpa_round_digits64. Both scales are constants.
+template <int From, int To>
+constexpr int64_t align(int64_t m) {
+    static_assert(From - To <= DPA_POW10_64_MAX && To - From <= DPA_POW10_64_MAX,
+                  "points too far apart for an int64 mantissa");
+    constexpr int64_t scale = pow10(From >= To ? From - To : To - From);
+    return From >= To ? m * scale
+                      : (m + (m < 0 ? -(scale / 2) : scale / 2)) / scale;
+}
+
+} // namespace dpa_fixed_detail
+
+template <int Point> struct dpa_fixed_acc;
+
+template <int Point>
+struct dpa_fixed {
+    static_assert(Point >= INT8_MIN && Point <= INT8_MAX, "point must fit dpa_t");
+    static constexpr int point = Point;
+
+    int32_t mantissa;
+
+    constexpr dpa_fixed() : mantissa(0) {}
+
+    static constexpr dpa_fixed from_mantissa(int32_t m) {
+        dpa_fixed x;
+        x.mantissa = m;
+        return x;
+    }
+
+    // Integer value (value * 10^-Point inside int32; rounded if Point > 0)
+    static constexpr dpa_fixed from_int(int32_t value) {
+        return from_mantissa((int32_t)dpa_fixed_detail::align<0, Point>(value));
+    }
+
+    // A dpa_t at any point: scaled up exactly or rounded, like
+    // dpa_array_from_dpa does for a block
+    explicit dpa_fixed(dpa_t x) : mantissa(0) {
+        const int shift = x.point - Point;
+        if (shift >= 0) {
+            mantissa = shift > DPA_POW10_32_MAX ? 0 : x.mantissa * dpa_pow10_32[shift];
+        } else {
+            mantissa = -shift > DPA_POW10_64_MAX
+                     ? 0 : (int32_t)dpa_round_digits64(x.mantissa, -shift);
+        }
+    }
+
+    operator dpa_t() const {
+        dpa_t x = {mantissa, (int8_t)Point};
+        return x;
+    }
+
+    template <int Q>
+    constexpr dpa_fixed<Q> rescale() const {
+        return dpa_fixed<Q>::from_mantissa((int32_t)dpa_fixed_detail::align<Point, Q>(mantissa));
+    }
+
+    constexpr dpa_fixed operator-() const {
+        return from_mantissa(-mantissa);
+    }
+};
+
+// Sum in int64 at a compile-time point: the wide partner of dpa_fixed, as
+// dpa_acc_t is of dpa_t
+template <int Point>
+struct dpa_fixed_acc {
+    static_assert(Point >= INT8_MIN && Point <= INT8_MAX, "point must fit dpa_acc_t");
+    static constexpr int point = Point;
+
+    int64_t mantissa;
+
+    constexpr dpa_fixed_acc() : mantissa(0) {}
+
+    static constexpr dpa_fixed_acc from_mantissa(int64_t m) {
+        dpa_fixed_acc x;
+        x.mantissa = m;
+        return x;
+    }
+
+    template <int P>
+    constexpr dpa_fixed_acc &operator+=(dpa_fixed_acc<P> x) {
+        mantissa += dpa_fixed_detail::align<P, Point>(x.mantissa);
+        return *this;
+    }
+
+    template <int P>
+    constexpr dpa_fixed_acc &operator+=(dpa_fixed<P> x) {
+        mantissa += dpa_fixed_detail::align<P, Point>(x.mantissa);
+        return *this;
+    }
+
+    template <int P>
+    constexpr dpa_fixed_acc &operator-=(dpa_fixed_acc<P> x) {
+        mantissa -= dpa_fixed_detail::align<P, Point>(x.mantissa);
+        return *this;
+    }
+
+    // The sum at point Q (the caller knows it fits int32 there)
+    template <int Q>
+    constexpr dpa_fixed<Q> round() const {
+        return dpa_fixed<Q>::from_mantissa((int32_t)dpa_fixed_detail::align<Point, Q>(mantissa));
+    }
+
+    // The sum as a dpa_t with the fewest digits dropped (dpa_acc_round)
+    dpa_t to_dpa() const {
+        return dpa_acc_round(*this);
+    }
+
+    operator dpa_acc_t() const {
+        dpa_acc_t acc = {mantissa, (int8_t)Point};
+        return acc;
+    }
+};
+
+template <int P, int Q>
+constexpr dpa_fixed<dpa_fixed_detail::min_point(P, Q)> operator+(dpa_fixed<P> a, dpa_fixed<Q> b) {
+    constexpr int R = dpa_fixed_detail::min_point(P, Q);
+    return dpa_fixed<R>::from_mantissa(a.template rescale<R>().mantissa +
+                                       b.template rescale<R>().mantissa);
+}
+
+template <int P, int Q>
+constexpr dpa_fixed<dpa_fixed_detail::min_point(P, Q)> operator-(dpa_fixed<P> a, dpa_fixed<Q> b) {
+    return a + -b;
+}
+
+template <int P, int Q>
+constexpr dpa_fixed_acc<P + Q> operator*(dpa_fixed<P> a, dpa_fixed<Q> b) {
+    return dpa_fixed_acc<P + Q>::from_mantissa((int64_t)a.mantissa * b.mantissa);
+}
+
+#endif // DPA_FIXED_HPP
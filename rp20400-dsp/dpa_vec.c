@@ -0,0 +1,129 @@
+/*
+ * Batch DPA operations on shared-point arrays
+ */
+
+#include <string.h>
+#include "dpa_vec.h"
+
+// ============================================================================
+// BACKEND DISPATCH
+// ============================================================================
+
+#if DPA_VEC_X86
+static const dpa_vec_kernels_t dpa_vec_scalar_kernels = {
+    dpa_dot_i32, dpa_dot_sym_i32, dpa_dot_antisym_i32, dpa_add_scaled_i32,
+    dpa_mul_i32, dpa_scale_i32, dpa_peak_product_i32, dpa_peak_i32
+};
+
+const dpa_vec_kernels_t *dpa_vec_kernels = &dpa_vec_scalar_kernels;
+
+static int dpa_vec_supported(dpa_vec_backend_t backend) {
+    switch (backend) {
+    case DPA_VEC_SCALAR: return 1;
+    case DPA_VEC_SSE41:  return __builtin_cpu_supports("sse4.1");
+    case DPA_VEC_AVX2:   return __builtin_cpu_supports("avx2");
+    }
+    return 0;
+}
+
+dpa_vec_backend_t dpa_vec_backend(void) {
+    if (dpa_vec_kernels == &dpa_vec_avx2_kernels) return DPA_VEC_AVX2;
+    if (dpa_vec_kernels == &dpa_vec_sse41_kernels) return DPA_VEC_SSE41;
+    return DPA_VEC_SCALAR;
+}
+
+int dpa_vec_select(dpa_vec_backend_t backend) {
+    __builtin_cpu_init();
+    if (!dpa_vec_supported(backend)) return -1;
+    
+    dpa_vec_kernels = backend == DPA_VEC_AVX2  ? &dpa_vec_avx2_kernels
+                    : backend == DPA_VEC_SSE41 ? &dpa_vec_sse41_kernels
+                    : &dpa_vec_scalar_kernels;
+    return 0;
+}
+
+// Runs before main, so every kernel call sees the final table
+__attribute__((constructor)) static void dpa_vec_detect(void) {
+    if (dpa_vec_select(DPA_VEC_AVX2) != 0) dpa_vec_select(DPA_VEC_SSE41);
+}
+#else
+dpa_vec_backend_t dpa_vec_backend(void) {
+    return DPA_VEC_SCALAR;
+}
+
+int dpa_vec_select(dpa_vec_backend_t backend) {
+    return backend == DPA_VEC_SCALAR ? 0 : -1;
+}
+#endif
+
+// ============================================================================
+// SHARED-POINT ARRAY OPERATIONS
+// ============================================================================
+
+// Digits to drop so a product of magnitude peak fits int32
+static inline int dpa_vec_digits(uint64_t peak) {
+    return peak > INT32_MAX ? dpa_product_shift(peak) : 0;
+}
+
+void dpa_add_n(const dpa_array_t *a, const dpa_array_t *b, dpa_array_t *out) {
+    const int n = a->length;
+
+    // Order so that `fine` has the finer (or equal) point
+    const dpa_array_t *fine = a->point <= b->point ? a : b;
+    const dpa_array_t *coarse = fine == a ? b : a;
+    const int shift = coarse->point - fine->point;
+
+    if (shift > DPA_POW10_32_MAX) {
+        memmove(out->mantissa, coarse->mantissa, n * sizeof(int32_t));
+        out->point = coarse->point;
+    } else {
+        dpa_vec_add_scaled(out->mantissa, fine->mantissa, coarse->mantissa,
+                           dpa_pow10_32[shift], n);
+        out->point = fine->point;
+    }
+    out->length = n;
+}
+
+void dpa_mul_n(const dpa_array_t *a, const dpa_array_t *b, dpa_array_t *out) {
+    const int n = a->length;
+    const int digits = dpa_vec_digits(dpa_vec_peak_product(a->mantissa, b->mantissa, n));
+
+    out->point = (int8_t)(a->point + b->point + digits);
+    dpa_vec_mul(out->mantissa, a->mantissa, b->mantissa, digits, n);
+    out->length = n;
+}
+
+void dpa_scale_n(const dpa_array_t *a, dpa_t s, dpa_array_t *out) {
+    const int n = a->length;
+    const uint32_t cm = s.mantissa < 0 ? -(uint32_t)s.mantissa : (uint32_t)s.mantissa;
+    const int digits = dpa_vec_digits((uint64_t)dpa_vec_peak(a->mantissa, n) * cm);
+
+    out->point = (int8_t)(a->point + s.point + digits);
+    dpa_vec_scale(out->mantissa, a->mantissa, s.mantissa, digits, n);
+    out->length = n;
+}
+
+dpa_t dpa_dot_n(const dpa_array_t *a, const dpa_array_t *b) {
+    dpa_acc_t acc = dpa_acc(a->point + b->point);
+    acc.mantissa = dpa_vec_dot(a->mantissa, b->mantissa, a->length);
+    return dpa_acc_round(acc);
+}
+
+int dpa_mac_n(dpa_array_t *acc, const dpa_array_t *x, dpa_t c) {
+    const int n = acc->length;
+    const int shift = x->point + c.point - acc->point;
+    int32_t *y = acc->mantissa;
+    const int32_t *m = x->mantissa;
+
+    if (shift > DPA_POW10_32_MAX) return -1;
+    if (shift >= 0) {
+        // Products are at or above acc's resolution: fold the scale into c
+        const int64_t cs = (int64_t)c.mantissa * dpa_pow10_32[shift];
+        for (int i = 0; i < n; i++) y[i] += (int32_t)(cs * m[i]);
+    } else if (-shift <= DPA_POW10_64_MAX) {
+        for (int i = 0; i < n; i++) {
+            y[i] += (int32_t)dpa_round_digits64((int64_t)c.mantissa * m[i], -shift);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * Batch DPA operations on shared-point arrays
+ *
+ * The scalar primitives align points and check for overflow on every
+ * element. On a dpa_array_t every element has the same point, so each call
+ * here makes its point decision once (alignment scale, digits to drop) and
+ * then runs a plain integer loop over the span.
+ *
+ * The loops themselves are the raw mantissa kernels (dpa_*_i32 / _i64),
+ * also used directly by kernels that already hold bare mantissas at a
+ * known point (FIR, beamformer, GSC). They are inline like dpa.h, so a
+ * constant tap count or length unrolls at the call site.
+ *
+ * On x86-64 hosts the span-length kernels also have SSE4.1 and AVX2
+ * versions (dpa_vec_x86.c), picked at startup from what the CPU supports
+ * and reached through the dpa_vec_* wrappers below. They are bit-exact with
+ * the scalar kernels. Elsewhere (the RP2040 build) the wrappers are the
+ * inline scalar kernels.
+ */
+
+#ifndef DPA_VEC_H
+#define DPA_VEC_H
+
+#include "dpa_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// RAW MANTISSA KERNELS
+// ============================================================================
+
+// sum a[i] * b[i] in int64 (the caller keeps n * max|a * b| below 2^63)
+static inline int64_t dpa_dot_i32(const int32_t *a, const int32_t *b, int n) {
+    int64_t acc = 0;
+    for (int i = 0; i < n; i++) {
+        acc += (int64_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+// sum c[i] * (x[i] + x[taps - 1 - i]) over the first half, plus the centre
+// tap when taps is odd: a symmetric FIR over a window, half the multiplies
+static inline int64_t dpa_dot_sym_i32(const int32_t *c, const int32_t *x, int taps) {
+    const int half = taps / 2;
+    int64_t acc = 0;
+    for (int i = 0; i < half; i++) {
+        acc += (int64_t)c[i] * (x[i] + x[taps - 1 - i]);
+    }
+    if (taps & 1) acc += (int64_t)c[half] * x[half];
+    return acc;
+}
+
+// sum c[i] * (x[i] - x[taps - 1 - i]) over the first half: antisymmetric
+// (the centre tap of an odd antisymmetric filter is zero)
+static inline int64_t dpa_dot_antisym_i32(const int32_t *c, const int32_t *x, int taps) {
+    const int half = taps / 2;
+    int64_t acc = 0;
+    for (int i = 0; i < half; i++) {
+        acc += (int64_t)c[i] * (x[i] - x[taps - 1 - i]);
+    }
+    return acc;
+}
+
+// acc[i] += c * x[i]
+static inline void dpa_mac_i64(int64_t *acc, const int32_t *x, int32_t c, int n) {
+    for (int i = 0; i < n; i++) {
+        acc[i] += (int64_t)c * x[i];
+    }
+}
+
+// acc[i] += sum c[k] * x[i + k] over k < taps: a short FIR along a span,
+// one pass over acc whatever the tap count
+static inline void dpa_correlate_i64(int64_t *acc, const int32_t *x, const int32_t *c,
+                                     int taps, int n) {
+    for (int i = 0; i < n; i++) {
+        int64_t sum = 0;
+        for (int k = 0; k < taps; k++) {
+            sum += (int64_t)c[k] * x[i + k];
+        }
+        acc[i] += sum;
+    }
+}
+
+// out[i] = a[i] + b[i] * scale (out may alias a or b)
+static inline void dpa_add_scaled_i32(int32_t *out, const int32_t *a, const int32_t *b,
+                                      int32_t scale, int n) {
+    for (int i = 0; i < n; i++) {
+        out[i] = a[i] + b[i] * scale;
+    }
+}
+
+// out[i] = a[i] * b[i] with `digits` decimal digits dropped, rounding half
+// away from zero (out may alias a or b)
+static inline void dpa_mul_i32(int32_t *out, const int32_t *a, const int32_t *b, int digits,
+                               int n) {
+    if (digits == 0) {
+        for (int i = 0; i < n; i++) out[i] = a[i] * b[i];
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        out[i] = (int32_t)dpa_round_digits64((int64_t)a[i] * b[i], digits);
+    }
+}
+
+// out[i] = a[i] * c with `digits` digits dropped as above
+static inline void dpa_scale_i32(int32_t *out, const int32_t *a, int32_t c, int digits, int n) {
+    if (digits == 0) {
+        for (int i = 0; i < n; i++) out[i] = a[i] * c;
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        out[i] = (int32_t)dpa_round_digits64((int64_t)a[i] * c, digits);
+    }
+}
+
+// max |a[i] * b[i]|
+static inline uint64_t dpa_peak_product_i32(const int32_t *a, const int32_t *b, int n) {
+    uint64_t peak = 0;
+    for (int i = 0; i < n; i++) {
+        int64_t p = (int64_t)a[i] * b[i];
+        uint64_t mag = p < 0 ? -(uint64_t)p : (uint64_t)p;
+        if (mag > peak) peak = mag;
+    }
+    return peak;
+}
+
+// max |a[i]|
+static inline uint32_t dpa_peak_i32(const int32_t *a, int n) {
+    uint32_t peak = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t mag = a[i] < 0 ? -(uint32_t)a[i] : (uint32_t)a[i];
+        if (mag > peak) peak = mag;
+    }
+    return peak;
+}
+
+// ============================================================================
+// BACKEND DISPATCH
+// ============================================================================
+
+typedef enum {
+    DPA_VEC_SCALAR,
+    DPA_VEC_SSE41,
+    DPA_VEC_AVX2
+} dpa_vec_backend_t;
+
+// One implementation of each dispatched kernel, same contracts as above
+typedef struct {
+    int64_t  (*dot)(const int32_t *a, const int32_t *b, int n);
+    int64_t  (*dot_sym)(const int32_t *c, const int32_t *x, int taps);
+    int64_t  (*dot_antisym)(const int32_t *c, const int32_t *x, int taps);
+    void     (*add_scaled)(int32_t *out, const int32_t *a, const int32_t *b, int32_t scale,
+                           int n);
+    void     (*mul)(int32_t *out, const int32_t *a, const int32_t *b, int digits, int n);
+    void     (*scale)(int32_t *out, const int32_t *a, int32_t c, int digits, int n);
+    uint64_t (*peak_product)(const int32_t *a, const int32_t *b, int n);
+    uint32_t (*peak)(const int32_t *a, int n);
+} dpa_vec_kernels_t;
+
+// Backend in use. The best one the CPU supports is selected before main.
+dpa_vec_backend_t dpa_vec_backend(void);
+
+// Switch backend (benchmarks, or to pin the scalar path); returns -1 if
+// this build or CPU does not have it. Not safe while kernels are running.
+int dpa_vec_select(dpa_vec_backend_t backend);
+
+#if DPA_VEC_X86
+extern const dpa_vec_kernels_t *dpa_vec_kernels;
+
+extern const dpa_vec_kernels_t dpa_vec_sse41_kernels;
+extern const dpa_vec_kernels_t dpa_vec_avx2_kernels;
+#define DPA_VEC_CALL(name, scalar, ...) dpa_vec_kernels->name(__VA_ARGS__)
+#else
+#define DPA_VEC_CALL(name, scalar, ...) scalar(__VA_ARGS__)
+#endif
+
+// Whether dpa_vec_dot_sym / dpa_vec_dot_antisym beat dpa_vec_dot over all
+// the taps on the active backend. With AVX2 the pre-add and lane reversal
+// cost as much as the multiplies they save (bench_fir), so a caller that
+// has the full coefficient set should take the plain dot product.
+static inline int dpa_vec_fold_pays(void) {
+#if DPA_VEC_X86
+    return dpa_vec_kernels != &dpa_vec_avx2_kernels;
+#else
+    return 1;
+#endif
+}
+
+static inline int64_t dpa_vec_dot(const int32_t *a, const int32_t *b, int n) {
+    return DPA_VEC_CALL(dot, dpa_dot_i32, a, b, n);
+}
+
+static inline int64_t dpa_vec_dot_sym(const int32_t *c, const int32_t *x, int taps) {
+    return DPA_VEC_CALL(dot_sym, dpa_dot_sym_i32, c, x, taps);
+}
+
+static inline int64_t dpa_vec_dot_antisym(const int32_t *c, const int32_t *x, int taps) {
+    return DPA_VEC_CALL(dot_antisym, dpa_dot_antisym_i32, c, x, taps);
+}
+
+static inline void dpa_vec_add_scaled(int32_t *out, const int32_t *a, const int32_t *b,
+                                      int32_t scale, int n) {
+    DPA_VEC_CALL(add_scaled, dpa_add_scaled_i32, out, a, b, scale, n);
+}
+
+static inline void dpa_vec_mul(int32_t *out, const int32_t *a, const int32_t *b, int digits,
+                               int n) {
+    DPA_VEC_CALL(mul, dpa_mul_i32, out, a, b, digits, n);
+}
+
+static inline void dpa_vec_scale(int32_t *out, const int32_t *a, int32_t c, int digits, int n) {
+    DPA_VEC_CALL(scale, dpa_scale_i32, out, a, c, digits, n);
+}
+
+static inline uint64_t dpa_vec_peak_product(const int32_t *a, const int32_t *b, int n) {
+    return DPA_VEC_CALL(peak_product, dpa_peak_product_i32, a, b, n);
+}
+
+static inline uint32_t dpa_vec_peak(const int32_t *a, int n) {
+    return DPA_VEC_CALL(peak, dpa_peak_i32, a, n);
+}
+
+// ============================================================================
+// SHARED-POINT ARRAY OPERATIONS
+// ============================================================================
+//
+// a and b must have the same length; out needs room for that many
+// mantissas and may share storage with an input. Output points must stay
+// within int8.
+
+// out = a + b at the finer point, the coarser input scaled up once (the
+// caller keeps the sums inside int32, as for dpa_add). If the points are
+// more than DPA_POW10_32_MAX apart the finer input is below the coarser
+// one's resolution and out is a copy of the coarser input.
+void dpa_add_n(const dpa_array_t *a, const dpa_array_t *b, dpa_array_t *out);
+
+// out = a * b elementwise. The products are exact in int64; if the largest
+// does not fit int32 the fewest digits that make it fit are dropped from
+// every element, so out keeps one point.
+void dpa_mul_n(const dpa_array_t *a, const dpa_array_t *b, dpa_array_t *out);
+
+// out = a * s, normalised like dpa_mul_n
+void dpa_scale_n(const dpa_array_t *a, dpa_t s, dpa_array_t *out);
+
+// sum a[i] * b[i], accumulated exactly in a dpa_acc_t and rounded once
+// (the caller keeps the sum below 2^63)
+dpa_t dpa_dot_n(const dpa_array_t *a, const dpa_array_t *b);
+
+// acc += c * x elementwise, at acc's point: the products are brought to it
+// with one scale or one rounding step for the whole span (the caller keeps
+// the sums inside int32). Returns 0, or -1 with acc untouched if the
+// product point is more than DPA_POW10_32_MAX above acc's.
+int dpa_mac_n(dpa_array_t *acc, const dpa_array_t *x, dpa_t c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DPA_VEC_H
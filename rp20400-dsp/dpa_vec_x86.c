@@ -0,0 +1,294 @@
+/*
+ * SSE4.1 and AVX2 versions of the dispatched DPA vector kernels
+ *
+ * Built only for x86-64 hosts (DPA_VEC_X86). Each function is compiled for
+ * its instruction set with a target attribute, so the rest of the library
+ * keeps the baseline ISA and dpa_vec.c decides at startup whether these
+ * are ever called.
+ *
+ * Every kernel gives exactly the scalar result: products are formed 32 x 32
+ * -> 64 with _mm*_mul_epi32 (even lanes, then odd lanes shifted down) and
+ * summed in int64, and the int32 paths use the same wrapping multiply as
+ * the scalar code. The decimal rounding steps (mul/scale with digits > 0)
+ * need a 64-bit divide, which neither extension has, so those run the
+ * scalar kernel.
+ */
+
+#include <immintrin.h>
+#include "dpa_vec.h"
+
+// ============================================================================
+// SSE4.1
+// ============================================================================
+
+#define SSE41 __attribute__((target("sse4.1")))
+
+// a[0] * b[0] + a[2] * b[2] and a[1] * b[1] + a[3] * b[3], added into acc
+SSE41 static inline __m128i sse41_dot4(__m128i acc, __m128i a, __m128i b) {
+    acc = _mm_add_epi64(acc, _mm_mul_epi32(a, b));
+    return _mm_add_epi64(acc, _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)));
+}
+
+SSE41 static inline int64_t sse41_sum64(__m128i v) {
+    return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1);
+}
+
+SSE41 static inline __m128i sse41_load(const int32_t *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+
+// p[3], p[2], p[1], p[0]
+SSE41 static inline __m128i sse41_load_reversed(const int32_t *p) {
+    return _mm_shuffle_epi32(sse41_load(p), _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+SSE41 static int64_t sse41_dot(const int32_t *a, const int32_t *b, int n) {
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = sse41_dot4(acc, sse41_load(a + i), sse41_load(b + i));
+    }
+    return sse41_sum64(acc) + dpa_dot_i32(a + i, b + i, n - i);
+}
+
+// Shared by the symmetric folds: c[i] * (x[i] +- x[taps - 1 - i]) over the
+// first half, vector part only; returns how many i were done
+SSE41 static inline int sse41_fold(const int32_t *c, const int32_t *x, int taps, int negate,
+                                   int64_t *sum) {
+    const int half = taps / 2;
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= half; i += 4) {
+        __m128i lo = sse41_load(x + i);
+        __m128i hi = sse41_load_reversed(x + taps - 4 - i);
+        __m128i folded = negate ? _mm_sub_epi32(lo, hi) : _mm_add_epi32(lo, hi);
+        acc = sse41_dot4(acc, sse41_load(c + i), folded);
+    }
+    *sum = sse41_sum64(acc);
+    return i;
+}
+
+SSE41 static int64_t sse41_dot_sym(const int32_t *c, const int32_t *x, int taps) {
+    const int half = taps / 2;
+    int64_t acc;
+    int i = sse41_fold(c, x, taps, 0, &acc);
+    for (; i < half; i++) acc += (int64_t)c[i] * (x[i] + x[taps - 1 - i]);
+    if (taps & 1) acc += (int64_t)c[half] * x[half];
+    return acc;
+}
+
+SSE41 static int64_t sse41_dot_antisym(const int32_t *c, const int32_t *x, int taps) {
+    const int half = taps / 2;
+    int64_t acc;
+    int i = sse41_fold(c, x, taps, 1, &acc);
+    for (; i < half; i++) acc += (int64_t)c[i] * (x[i] - x[taps - 1 - i]);
+    return acc;
+}
+
+SSE41 static void sse41_add_scaled(int32_t *out, const int32_t *a, const int32_t *b,
+                                   int32_t scale, int n) {
+    const __m128i s = _mm_set1_epi32(scale);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_add_epi32(sse41_load(a + i), _mm_mullo_epi32(sse41_load(b + i), s));
+        _mm_storeu_si128((__m128i *)(out + i), v);
+    }
+    dpa_add_scaled_i32(out + i, a + i, b + i, scale, n - i);
+}
+
+SSE41 static void sse41_mul(int32_t *out, const int32_t *a, const int32_t *b, int digits,
+                            int n) {
+    int i = 0;
+    if (digits == 0) {
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_si128((__m128i *)(out + i),
+                             _mm_mullo_epi32(sse41_load(a + i), sse41_load(b + i)));
+        }
+    }
+    dpa_mul_i32(out + i, a + i, b + i, digits, n - i);
+}
+
+SSE41 static void sse41_scale(int32_t *out, const int32_t *a, int32_t c, int digits, int n) {
+    const __m128i s = _mm_set1_epi32(c);
+    int i = 0;
+    if (digits == 0) {
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_si128((__m128i *)(out + i), _mm_mullo_epi32(sse41_load(a + i), s));
+        }
+    }
+    dpa_scale_i32(out + i, a + i, c, digits, n - i);
+}
+
+SSE41 static uint32_t sse41_peak(const int32_t *a, int n) {
+    // abs(INT32_MIN) stays 0x80000000, which is right read as unsigned
+    __m128i peak = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        peak = _mm_max_epu32(peak, _mm_abs_epi32(sse41_load(a + i)));
+    }
+    peak = _mm_max_epu32(peak, _mm_shuffle_epi32(peak, _MM_SHUFFLE(1, 0, 3, 2)));
+    peak = _mm_max_epu32(peak, _mm_shuffle_epi32(peak, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t head = (uint32_t)_mm_cvtsi128_si32(peak);
+    uint32_t tail = dpa_peak_i32(a + i, n - i);
+    return head > tail ? head : tail;
+}
+
+// SSE4.1 has no 64-bit compare, so the product peak stays scalar
+const dpa_vec_kernels_t dpa_vec_sse41_kernels = {
+    sse41_dot, sse41_dot_sym, sse41_dot_antisym, sse41_add_scaled,
+    sse41_mul, sse41_scale, dpa_peak_product_i32, sse41_peak
+};
+
+// ============================================================================
+// AVX2
+// ============================================================================
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static inline __m256i avx2_dot8(__m256i acc, __m256i a, __m256i b) {
+    acc = _mm256_add_epi64(acc, _mm256_mul_epi32(a, b));
+    return _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_srli_epi64(a, 32),
+                                                  _mm256_srli_epi64(b, 32)));
+}
+
+AVX2 static inline int64_t avx2_sum64(__m256i v) {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+AVX2 static inline __m256i avx2_load(const int32_t *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+
+AVX2 static inline __m256i avx2_load_reversed(const int32_t *p) {
+    return _mm256_permutevar8x32_epi32(avx2_load(p), _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+AVX2 static int64_t avx2_dot(const int32_t *a, const int32_t *b, int n) {
+    // Two accumulators hide the add latency
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = avx2_dot8(acc0, avx2_load(a + i), avx2_load(b + i));
+        acc1 = avx2_dot8(acc1, avx2_load(a + i + 8), avx2_load(b + i + 8));
+    }
+    if (i + 8 <= n) {
+        acc0 = avx2_dot8(acc0, avx2_load(a + i), avx2_load(b + i));
+        i += 8;
+    }
+    return avx2_sum64(_mm256_add_epi64(acc0, acc1)) + dpa_dot_i32(a + i, b + i, n - i);
+}
+
+AVX2 static inline int avx2_fold(const int32_t *c, const int32_t *x, int taps, int negate,
+                                 int64_t *sum) {
+    const int half = taps / 2;
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= half; i += 8) {
+        __m256i lo = avx2_load(x + i);
+        __m256i hi = avx2_load_reversed(x + taps - 8 - i);
+        __m256i folded = negate ? _mm256_sub_epi32(lo, hi) : _mm256_add_epi32(lo, hi);
+        acc = avx2_dot8(acc, avx2_load(c + i), folded);
+    }
+    *sum = avx2_sum64(acc);
+    return i;
+}
+
+AVX2 static int64_t avx2_dot_sym(const int32_t *c, const int32_t *x, int taps) {
+    const int half = taps / 2;
+    int64_t acc;
+    int i = avx2_fold(c, x, taps, 0, &acc);
+    for (; i < half; i++) acc += (int64_t)c[i] * (x[i] + x[taps - 1 - i]);
+    if (taps & 1) acc += (int64_t)c[half] * x[half];
+    return acc;
+}
+
+AVX2 static int64_t avx2_dot_antisym(const int32_t *c, const int32_t *x, int taps) {
+    const int half = taps / 2;
+    int64_t acc;
+    int i = avx2_fold(c, x, taps, 1, &acc);
+    for (; i < half; i++) acc += (int64_t)c[i] * (x[i] - x[taps - 1 - i]);
+    return acc;
+}
+
+AVX2 static void avx2_add_scaled(int32_t *out, const int32_t *a, const int32_t *b,
+                                 int32_t scale, int n) {
+    const __m256i s = _mm256_set1_epi32(scale);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_add_epi32(avx2_load(a + i), _mm256_mullo_epi32(avx2_load(b + i), s));
+        _mm256_storeu_si256((__m256i *)(out + i), v);
+    }
+    dpa_add_scaled_i32(out + i, a + i, b + i, scale, n - i);
+}
+
+AVX2 static void avx2_mul(int32_t *out, const int32_t *a, const int32_t *b, int digits,
+                          int n) {
+    int i = 0;
+    if (digits == 0) {
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_si256((__m256i *)(out + i),
+                                _mm256_mullo_epi32(avx2_load(a + i), avx2_load(b + i)));
+        }
+    }
+    dpa_mul_i32(out + i, a + i, b + i, digits, n - i);
+}
+
+AVX2 static void avx2_scale(int32_t *out, const int32_t *a, int32_t c, int digits, int n) {
+    const __m256i s = _mm256_set1_epi32(c);
+    int i = 0;
+    if (digits == 0) {
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_si256((__m256i *)(out + i), _mm256_mullo_epi32(avx2_load(a + i), s));
+        }
+    }
+    dpa_scale_i32(out + i, a + i, c, digits, n - i);
+}
+
+// |p| for int64 lanes; the products here are at most 2^62, so the result
+// also compares correctly as signed
+AVX2 static inline __m256i avx2_abs64(__m256i p) {
+    __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), p);
+    return _mm256_sub_epi64(_mm256_xor_si256(p, sign), sign);
+}
+
+AVX2 static inline __m256i avx2_max64(__m256i a, __m256i b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+}
+
+AVX2 static uint64_t avx2_peak_product(const int32_t *a, const int32_t *b, int n) {
+    __m256i peak = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = avx2_load(a + i), y = avx2_load(b + i);
+        peak = avx2_max64(peak, avx2_abs64(_mm256_mul_epi32(x, y)));
+        peak = avx2_max64(peak, avx2_abs64(_mm256_mul_epi32(_mm256_srli_epi64(x, 32),
+                                                            _mm256_srli_epi64(y, 32))));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, peak);
+    uint64_t max = dpa_peak_product_i32(a + i, b + i, n - i);
+    for (int k = 0; k < 4; k++) {
+        if (lanes[k] > max) max = lanes[k];
+    }
+    return max;
+}
+
+AVX2 static uint32_t avx2_peak(const int32_t *a, int n) {
+    __m256i peak = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        peak = _mm256_max_epu32(peak, _mm256_abs_epi32(avx2_load(a + i)));
+    }
+    __m128i p = _mm_max_epu32(_mm256_castsi256_si128(peak), _mm256_extracti128_si256(peak, 1));
+    p = _mm_max_epu32(p, _mm_shuffle_epi32(p, _MM_SHUFFLE(1, 0, 3, 2)));
+    p = _mm_max_epu32(p, _mm_shuffle_epi32(p, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t head = (uint32_t)_mm_cvtsi128_si32(p);
+    uint32_t tail = dpa_peak_i32(a + i, n - i);
+    return head > tail ? head : tail;
+}
+
+const dpa_vec_kernels_t dpa_vec_avx2_kernels = {
+    avx2_dot, avx2_dot_sym, avx2_dot_antisym, avx2_add_scaled,
+    avx2_mul, avx2_scale, avx2_peak_product, avx2_peak
+};
@@ -0,0 +1,71 @@
+/*
+ * DSP kernels built on DPA arithmetic
+ */
+
+#include "dsp.h"
+#include "dpa_vec.h"
+
+// ============================================================================
+// ADC INPUT CONVERSION
+// ============================================================================
+
+void adc_demux(const uint16_t *adc_samples, int32_t out[ADC_CHANNELS][BUFFER_SIZE],
+               int samples) {
+    // (raw - ADC_MIDSCALE) * 10^-point folded into one multiply-subtract
+    const int32_t scale  = dpa_pow10_32[-FIR_INPUT_POINT];
+    const int32_t offset = ADC_MIDSCALE * scale;
+    
+    // Read the capture once, front to back, and scatter to the channel rows
+    const uint16_t *src = adc_samples;
+    for (int i = 0; i < samples; i++) {
+        for (int ch = 0; ch < ADC_CHANNELS; ch++) {
+            out[ch][i] = (int32_t)*src++ * scale - offset;
+        }
+    }
+}
+
+// ============================================================================
+// BASIC FFT IMPLEMENTATION (POWER-OF-2 SIZES)
+// ============================================================================
+
+// cos and sin of 2*pi*i / FFT_SIZE for i in [0, FFT_SIZE) from the
+// quarter-wave table, as mantissas at point -DFT_TWIDDLE_DIGITS
+static inline void dft_twiddle(int i, int32_t *c, int32_t *s) {
+    const int quarter = FFT_SIZE / 4;
+    
+    switch (i / quarter) {
+    case 0:  *c =  dft_quarter_sine[quarter - i];         *s =  dft_quarter_sine[i];                break;
+    case 1:  *c = -dft_quarter_sine[i - quarter];         *s =  dft_quarter_sine[2 * quarter - i];  break;
+    case 2:  *c = -dft_quarter_sine[3 * quarter - i];     *s = -dft_quarter_sine[i - 2 * quarter];  break;
+    default: *c =  dft_quarter_sine[i - 3 * quarter];     *s = -dft_quarter_sine[4 * quarter - i];  break;
+    }
+}
+
+// Simple DFT for small sizes (more practical for microcontroller)
+int dpa_dft(dpa_t *input, dpa_t *real_out, dpa_t *imag_out, int N, int32_t *work) {
+    if (N < 1 || N > FFT_SIZE || (N & (N - 1))) return -1;
+    int32_t *x_m = work, *cos_m = work + N, *msin_m = work + 2 * N;
+    
+    // The input at one point, then each bin is two dot products against a
+    // row of twiddles, each exact in int64 and normalised once
+    dpa_array_t x = dpa_array(x_m, N, 0);
+    dpa_array_from_dpa(&x, input, N);
+    dpa_array_t cos_row = dpa_array(cos_m, N, -DFT_TWIDDLE_DIGITS);
+    dpa_array_t msin_row = dpa_array(msin_m, N, -DFT_TWIDDLE_DIGITS);
+    
+    for (int k = 0; k < N/2; k++) { // Only compute positive frequencies
+        int kn = 0; // k*n mod N, kept incrementally
+        for (int n = 0; n < N; n++) {
+            int32_t s;
+            dft_twiddle(kn * FFT_SIZE / N, &cos_m[n], &s);
+            msin_m[n] = -s;
+            
+            kn += k;
+            if (kn >= N) kn -= N;
+        }
+        
+        real_out[k] = dpa_dot_n(&x, &cos_row);
+        imag_out[k] = dpa_dot_n(&x, &msin_row);
+    }
+    return 0;
+}
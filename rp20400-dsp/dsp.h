@@ -0,0 +1,89 @@
+/*
+ * DSP kernels built on DPA arithmetic
+ *
+ * ADC conversion and DFT (FIR filters live in fir.h, beamforming in
+ * beamform.h).
+ * Nothing in here touches the RP2040
+ * peripherals, so the kernels build into the host library as well.
+ */
+
+#ifndef DSP_H
+#define DSP_H
+
+#include "dpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// DSP CONFIGURATION
+// ============================================================================
+
+#define SAMPLE_RATE_HZ      8000
+#define BUFFER_SIZE         256
+#define FIR_TAPS           32
+#ifndef FFT_SIZE
+#define FFT_SIZE           64
+#endif
+#define ADC_CHANNELS       3  // Use ADC0, ADC1, ADC2
+#define NUM_SENSORS        ADC_CHANNELS // one sensor per ADC input
+#define ADC_MIDSCALE       2048 // 12-bit ADC zero level
+
+// Point of the converted ADC samples and of the FIR delay lines
+#define FIR_INPUT_POINT    (-4)
+
+// Decimate the filtered channels by this factor before beamforming and the
+// FFT (1 = full rate). fir_coeffs cuts off at 1 kHz, so up to 4 at 8 kHz.
+#ifndef DECIMATION_FACTOR
+#define DECIMATION_FACTOR  1
+#endif
+#define DECIMATED_SIZE     (BUFFER_SIZE / DECIMATION_FACTOR)
+
+// Beamformer array: NUM_SENSORS sensors in a line along x, SENSOR_SPACING_UM
+// apart (85.75 mm is two samples of sound travel at 8 kHz), steered
+// BEAM_STEER_DEG away from the array axis
+#define SOUND_SPEED_MM_S   343000
+#define SENSOR_SPACING_UM  85750
+#ifndef BEAM_STEER_DEG
+#define BEAM_STEER_DEG     0
+#endif
+
+// dpa_dft twiddles: decimal mantissas at point -DFT_TWIDDLE_DIGITS
+// (generated by CMake along with the FFT table)
+#ifndef DFT_TWIDDLE_DIGITS
+#define DFT_TWIDDLE_DIGITS 4
+#endif
+
+// ============================================================================
+// ADC INPUT CONVERSION
+// ============================================================================
+
+// De-interleave a round-robin capture (ch0, ch1, ch2, ch0, ...) of
+// `samples` frames into one row per channel, removing the ADC_MIDSCALE
+// offset and converting to DPA in the same pass. Each row is a run of
+// mantissas sharing FIR_INPUT_POINT (a dpa_array_t's storage).
+void adc_demux(const uint16_t *adc_samples, int32_t out[ADC_CHANNELS][BUFFER_SIZE],
+               int samples);
+
+// ============================================================================
+// BASIC FFT (POWER-OF-2 SIZES)
+// ============================================================================
+
+// sin(2*pi*i / FFT_SIZE) at point -DFT_TWIDDLE_DIGITS, i = 0..FFT_SIZE/4
+extern const int32_t dft_quarter_sine[FFT_SIZE / 4 + 1];
+
+// Bins 0..N/2-1 of X[k] = sum x[n] e^(-j 2 pi k n / N). N is a power of
+// two no larger than FFT_SIZE, so the angles are exact. Each bin is
+// accumulated exactly and rounded once (dpa_dot_n). work holds
+// DPA_DFT_WORK(N) int32 values: three N-long rows for the input, the
+// cosines and the negated sines. Returns 0, or -1 for a bad N (the outputs
+// are then left untouched).
+#define DPA_DFT_WORK(N)     (3 * (N))
+int dpa_dft(dpa_t *input, dpa_t *real_out, dpa_t *imag_out, int N, int32_t *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_H
@@ -0,0 +1,181 @@
+/*
+ * In-place radix-2 decimation-in-time FFT over DPA fixed-point data
+ */
+
+#include "fft.h"
+
+// A radix-2 butterfly grows a component by at most 1 + sqrt(2), so a block
+// whose largest component is below 2^29 cannot overflow int32 in one stage
+#define FFT_HEADROOM_LIMIT  (1 << 29)
+
+int8_t dpa_fft_load_real(const dpa_t *in, dpa_cpx_t *out, int N) {
+    // Finest point every sample can reach without overflowing (samples
+    // finer than that are rounded); zeros don't pull the point down
+    const int point = dpa_array_common_point(in, N);
+    
+    for (int i = 0; i < N; i++) {
+        out[i].re = dpa_mantissa_round_at(in[i], point);
+        out[i].im = 0;
+    }
+    
+    return (int8_t)point;
+}
+
+static void fft_bit_reverse(dpa_cpx_t *data, int N) {
+    for (int i = 1, j = 0; i < N; i++) {
+        int bit = N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        
+        if (i < j) {
+            dpa_cpx_t tmp = data[i];
+            data[i] = data[j];
+            data[j] = tmp;
+        }
+    }
+}
+
+// Divide the block by 10 (rounding) until it has headroom for one stage
+static void fft_block_scale(dpa_cpx_t *data, int N, int8_t *point) {
+    uint32_t peak = 0;
+    for (int i = 0; i < N; i++) {
+        uint32_t re = data[i].re < 0 ? -(uint32_t)data[i].re : (uint32_t)data[i].re;
+        uint32_t im = data[i].im < 0 ? -(uint32_t)data[i].im : (uint32_t)data[i].im;
+        if (re > peak) peak = re;
+        if (im > peak) peak = im;
+    }
+    
+    while (peak >= FFT_HEADROOM_LIMIT) {
+        for (int i = 0; i < N; i++) {
+            data[i].re = (int32_t)dpa_round_digits64(data[i].re, 1);
+            data[i].im = (int32_t)dpa_round_digits64(data[i].im, 1);
+        }
+        peak /= 10;
+        (*point)++;
+    }
+}
+
+// cos and sin of 2*pi*i / FFT_MAX_SIZE for i in [0, FFT_MAX_SIZE/2)
+static inline void fft_twiddle(int i, int32_t *c, int32_t *s) {
+    if (i <= FFT_MAX_SIZE / 4) {
+        *c = fft_quarter_sine[FFT_MAX_SIZE / 4 - i];
+        *s = fft_quarter_sine[i];
+    } else {
+        *c = -fft_quarter_sine[i - FFT_MAX_SIZE / 4];
+        *s = fft_quarter_sine[FFT_MAX_SIZE / 2 - i];
+    }
+}
+
+// Radix-2 core for any power of two N in [2, FFT_MAX_SIZE]
+static void fft_radix2(dpa_cpx_t *data, int N, int8_t *point) {
+    fft_bit_reverse(data, N);
+    
+    const int64_t round = (int64_t)1 << (FFT_TWIDDLE_BITS - 1);
+    
+    for (int len = 2; len <= N; len <<= 1) {
+        fft_block_scale(data, N, point);
+        
+        int half = len >> 1;
+        int step = FFT_MAX_SIZE / len;
+        
+        for (int k = 0; k < half; k++) {
+            int32_t c, s;
+            fft_twiddle(k * step, &c, &s);
+            
+            for (int j = k; j < N; j += len) {
+                dpa_cpx_t a = data[j];
+                dpa_cpx_t b = data[j + half];
+                
+                // t = b * (cos - j sin)
+                int32_t tr = (int32_t)(((int64_t)b.re * c + (int64_t)b.im * s + round)
+                                       >> FFT_TWIDDLE_BITS);
+                int32_t ti = (int32_t)(((int64_t)b.im * c - (int64_t)b.re * s + round)
+                                       >> FFT_TWIDDLE_BITS);
+                
+                data[j]        = (dpa_cpx_t){a.re + tr, a.im + ti};
+                data[j + half] = (dpa_cpx_t){a.re - tr, a.im - ti};
+            }
+        }
+    }
+}
+
+int dpa_fft(dpa_cpx_t *data, int N, int8_t *point) {
+    if (N < FFT_MIN_SIZE || N > FFT_MAX_SIZE || (N & (N - 1))) return -1;
+    
+    fft_radix2(data, N, point);
+    return 0;
+}
+
+// One output bin of the real-FFT split: with A = Z[k], B = conj(Z[M-k]),
+// 2X[k] = (A + B) - j W_N^k (A - B)
+static inline dpa_cpx_t fft_real_split(dpa_cpx_t a, dpa_cpx_t b, int32_t c, int32_t s) {
+    const int64_t round = (int64_t)1 << (FFT_TWIDDLE_BITS - 1);
+    
+    int64_t er = (int64_t)a.re + b.re, ei = (int64_t)a.im + b.im;
+    int64_t gr = (int64_t)a.im - b.im, gi = (int64_t)b.re - a.re; // -j (A - B)
+    
+    // W * G with W = cos - j sin
+    int64_t wr = (gr * c + gi * s + round) >> FFT_TWIDDLE_BITS;
+    int64_t wi = (gi * c - gr * s + round) >> FFT_TWIDDLE_BITS;
+    
+    return (dpa_cpx_t){(int32_t)((er + wr) >> 1), (int32_t)((ei + wi) >> 1)};
+}
+
+// Transform and split a real frame already packed into out[0..N/2-1]
+// (even samples in re, odd in im) at *point
+static void fft_real_packed(dpa_cpx_t *out, int N, int8_t *point) {
+    const int M = N / 2;
+    
+    fft_radix2(out, M, point);
+    fft_block_scale(out, M, point);
+    
+    // DC and Nyquist are both real and come from Z[0] alone
+    dpa_cpx_t z0 = out[0];
+    out[0] = (dpa_cpx_t){z0.re + z0.im, 0};
+    out[M] = (dpa_cpx_t){z0.re - z0.im, 0};
+    
+    // Remaining bins in (k, M-k) pairs so the split can run in place
+    for (int k = 1; k <= M / 2; k++) {
+        dpa_cpx_t a = out[k];
+        dpa_cpx_t b = out[M - k];
+        int32_t c, s;
+        
+        fft_twiddle(k * (FFT_MAX_SIZE / N), &c, &s);
+        out[k] = fft_real_split(a, (dpa_cpx_t){b.re, -b.im}, c, s);
+        
+        if (k != M - k) {
+            // W_N^(M-k) = -conj(W_N^k)
+            out[M - k] = fft_real_split(b, (dpa_cpx_t){a.re, -a.im}, -c, s);
+        }
+    }
+}
+
+int dpa_fft_real(const dpa_t *in, dpa_cpx_t *out, int N, int8_t *point) {
+    if (N < FFT_MIN_SIZE || N > FFT_MAX_SIZE || (N & (N - 1))) return -1;
+    
+    // Pack even samples into re and odd samples into im, at the same block
+    // point dpa_fft_load_real picks
+    const int p = dpa_array_common_point(in, N);
+    for (int i = 0; i < N / 2; i++) {
+        out[i].re = dpa_mantissa_round_at(in[2 * i], p);
+        out[i].im = dpa_mantissa_round_at(in[2 * i + 1], p);
+    }
+    *point = (int8_t)p;
+    
+    fft_real_packed(out, N, point);
+    return 0;
+}
+
+int dpa_fft_real_array(const dpa_array_t *in, dpa_cpx_t *out, int N, int8_t *point) {
+    if (N < FFT_MIN_SIZE || N > FFT_MAX_SIZE || (N & (N - 1))) return -1;
+    if (in->length < N) return -1;
+    
+    const int32_t *m = in->mantissa;
+    for (int i = 0; i < N / 2; i++) {
+        out[i] = (dpa_cpx_t){m[2 * i], m[2 * i + 1]};
+    }
+    *point = in->point;
+    
+    fft_real_packed(out, N, point);
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * In-place radix-2 FFT over DPA fixed-point data
+ *
+ * The frame is an array of complex mantissas sharing one decimal point
+ * (block exponent). Twiddles are binary Q-format so the butterfly needs only
+ * a multiply and a shift; they scale the data without moving its point.
+ * Whenever a stage could overflow int32 the whole block is divided by 10
+ * and the point bumped, so the result is always value = mantissa * 10^point.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+#include "dpa.h"
+#include "dpa_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// FFT_MAX_SIZE and FFT_TWIDDLE_BITS are normally set by CMake, which
+// generates fft_quarter_sine to match (see tools/gen_twiddle.py)
+#define FFT_MIN_SIZE        16
+#ifndef FFT_MAX_SIZE
+#define FFT_MAX_SIZE        4096
+#endif
+#ifndef FFT_TWIDDLE_BITS
+#define FFT_TWIDDLE_BITS    30
+#endif
+
+typedef struct {
+    int32_t re;
+    int32_t im;
+} dpa_cpx_t;
+
+// sin(2*pi*i / FFT_MAX_SIZE) in Q(FFT_TWIDDLE_BITS), i = 0..FFT_MAX_SIZE/4
+extern const int32_t fft_quarter_sine[FFT_MAX_SIZE / 4 + 1];
+
+// Load N real DPA samples as a complex block. The block point is the
+// finest one every sample reaches without overflow (dpa_array_common_point);
+// samples finer than it are rounded. Returns that point.
+int8_t dpa_fft_load_real(const dpa_t *in, dpa_cpx_t *out, int N);
+
+// Forward FFT of N points in place, N a power of two in
+// [FFT_MIN_SIZE, FFT_MAX_SIZE]. *point is the block point of the input and
+// receives the block point of the output. Returns 0, or -1 for a bad N.
+int dpa_fft(dpa_cpx_t *data, int N, int8_t *point);
+
+// Forward FFT of N real samples via one N/2-point complex FFT plus a split
+// pass: about half the arithmetic of dpa_fft (bench_fft times the two).
+// The bins are not those of dpa_fft: the split rounds and scales at other
+// steps, so they differ by up to about 7 lsb of the coarser output point.
+// Writes bins 0..N/2 (out needs N/2 + 1 entries) and the output block
+// point to *point. N as for dpa_fft. Returns 0, or -1 for a bad N.
+int dpa_fft_real(const dpa_t *in, dpa_cpx_t *out, int N, int8_t *point);
+
+// Same from the first N mantissas of a shared-point array, which are
+// packed as they are. Also returns -1 if in->length < N.
+int dpa_fft_real_array(const dpa_array_t *in, dpa_cpx_t *out, int N, int8_t *point);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FFT_H
@@ -0,0 +1,330 @@
+/*
+ * Per-channel FIR filters in block-exponent DPA
+ */
+
+#include <string.h>
+#include "fir.h"
+#include "dpa_vec.h"
+
+// FIR filter coefficients (low-pass, Fs=8kHz, Fc=1kHz)
+// Pre-converted to DPA format for efficiency
+const dpa_t fir_coeffs[FIR_TAPS] = {
+    {-41, -6},   {-134, -6},  {-207, -6},  {-180, -6},
+    {-12, -6},   {244, -6},   {494, -6},   {583, -6},
+    {394, -6},   {-67, -6},   {-693, -6},  {-1266, -6},
+    {-1528, -6}, {-1246, -6}, {-434, -6},  {1116, -6},
+    {3395, -6},  {6251, -6},  {9367, -6},  {12358, -6},
+    {14808, -6}, {16371, -6}, {16763, -6}, {15808, -6},
+    {13459, -6}, {9806, -6},  {5081, -6},  {-331, -6},
+    {-5806, -6}, {-10646, -6},{-14308, -6},{-16540, -6}
+};
+
+// Coefficient mantissas in design order. DPA_DECIMAL holds them at the
+// finest point among the coefficients; DPA_BINARY at the binary point that
+// gives the largest one FIR_COEFF_BITS bits, each rounded from its exact
+// decimal value. Returns the point, or 1 (invalid) if there is none: the
+// points must lie within DPA_POW10_32_MAX of each other so every
+// coefficient reaches the finest one, and a decimal point below
+// -DPA_POW10_64_MAX is more digits than the accumulator can drop.
+static int fir_load_coeffs(const fir_design_t *design, int32_t *mantissas) {
+    const dpa_t *coeffs = design->coeffs;
+    const int taps = design->taps;
+    
+    int point = coeffs[0].point, coarsest = coeffs[0].point;
+    for (int i = 1; i < taps; i++) {
+        if (coeffs[i].point < point) point = coeffs[i].point;
+        if (coeffs[i].point > coarsest) coarsest = coeffs[i].point;
+    }
+    if (point > 0 || coarsest - point > DPA_POW10_32_MAX) return 1;
+    if (design->mode == DPA_DECIMAL && point < -DPA_POW10_64_MAX) return 1;
+    
+    int64_t largest = 0;
+    for (int i = 0; i < taps; i++) {
+        mantissas[i] = dpa_mantissa_at(coeffs[i], point);
+        int64_t mag = mantissas[i] < 0 ? -(int64_t)mantissas[i] : mantissas[i];
+        if (mag > largest) largest = mag;
+    }
+    if (design->mode == DPA_DECIMAL) return point;
+    
+    // value * 2^bits = mantissa * 2^bits / 10^digits must stay below
+    // 2^FIR_COEFF_BITS for the largest coefficient
+    const int digits = -point;
+    if (digits > DPA_POW10_32_MAX) return 1;
+    const int64_t limit = ((int64_t)1 << FIR_COEFF_BITS) * dpa_pow10_32[digits];
+    if (largest >= limit) return 1;
+    
+    int bits = 0;
+    while (bits < 62 && (largest << (bits + 1)) < limit) bits++;
+    
+    for (int i = 0; i < taps; i++) {
+        mantissas[i] = (int32_t)dpa_round_digits64((int64_t)mantissas[i] * ((int64_t)1 << bits),
+                                                   digits);
+    }
+    return -bits;
+}
+
+// Drop the coefficient point from an accumulator: digits or bits by mode
+static inline int32_t fir_normalise(int64_t acc, int drop, dpa_mode_t mode) {
+    return (int32_t)(mode == DPA_BINARY ? dpa2_round_bits64(acc, drop)
+                                        : dpa_round_digits64(acc, drop));
+}
+
+int fir_init(fir_state_t *st, const fir_design_t *design, int input_point) {
+    int32_t mantissas[FIR_MAX_TAPS];
+    const int taps = design->taps;
+    
+    if (taps < 1 || taps > FIR_MAX_TAPS) return -1;
+    
+    int point = fir_load_coeffs(design, mantissas);
+    if (point > 0) return -1;
+    
+    // Reversed so that the oldest sample in the window meets the last tap
+    for (int i = 0; i < taps; i++) {
+        st->coeffs[taps - 1 - i] = mantissas[i];
+    }
+    
+    if (design->symmetry != FIR_GENERAL) {
+        int sign = design->symmetry == FIR_SYMMETRIC ? 1 : -1;
+        for (int i = 0; i < taps; i++) {
+            if (st->coeffs[i] != sign * st->coeffs[taps - 1 - i]) return -1;
+        }
+    }
+    
+    st->taps = taps;
+    st->symmetry = design->symmetry;
+    st->mode = design->mode;
+    st->coeff_point = (int8_t)point;
+    st->input_point = (int8_t)input_point;
+    fir_reset(st);
+    
+    return 0;
+}
+
+void fir_reset(fir_state_t *st) {
+    memset(st->delay, 0, sizeof(st->delay));
+    st->index = 0;
+}
+
+// Write one sample into a mirrored delay line of length `len`; returns the
+// new index. The newest `len` samples are then delay[index + 1 .. index + len].
+static inline int fir_push(int32_t *delay, int index, int len, int32_t sample) {
+    if (++index == len) index = 0;
+    delay[index] = sample;
+    delay[index + len] = sample;
+    return index;
+}
+
+// Contiguous window, oldest first: a pure int32 x int32 -> int64 dot
+// product with no wrap and no per-tap alignment. Symmetric designs pre-add
+// mirrored samples for half the multiplies, unless the backend's full dot
+// is as fast (all the coefficients are stored, so either gives the sum).
+static inline int64_t fir_dot(const int32_t *coeffs, const int32_t *window, int taps,
+                              fir_symmetry_t symmetry) {
+    if (!dpa_vec_fold_pays()) symmetry = FIR_GENERAL;
+    switch (symmetry) {
+    case FIR_SYMMETRIC:
+        return dpa_vec_dot_sym(coeffs, window, taps);
+    case FIR_ANTISYMMETRIC:
+        return dpa_vec_dot_antisym(coeffs, window, taps);
+    case FIR_GENERAL:
+    default:
+        return dpa_vec_dot(coeffs, window, taps);
+    }
+}
+
+// Samples converted per pass when the input is not already mantissas at
+// the input point
+#define FIR_CHUNK 32
+
+// Core loop: n mantissas at the input point in, n out (in and out may alias)
+static void fir_run(fir_state_t *st, const int32_t *in, int32_t *out, int n) {
+    const int taps = st->taps;
+    const int drop = -st->coeff_point;
+    int index = st->index;
+    
+    for (int s = 0; s < n; s++) {
+        index = fir_push(st->delay, index, taps, in[s]);
+        int64_t acc = fir_dot(st->coeffs, &st->delay[index + 1], taps, st->symmetry);
+        
+        // Apply the point once: acc is at coeff_point + input_point
+        out[s] = fir_normalise(acc, drop, st->mode);
+    }
+    
+    st->index = index;
+}
+
+void fir_process_block(fir_state_t *st, const dpa_t *in, dpa_t *out, int n) {
+    const int input_point = st->input_point;
+    int32_t m[FIR_CHUNK];
+    
+    for (int done = 0; done < n; done += FIR_CHUNK) {
+        const int len = n - done < FIR_CHUNK ? n - done : FIR_CHUNK;
+        for (int k = 0; k < len; k++) m[k] = dpa_mantissa_at(in[done + k], input_point);
+        fir_run(st, m, m, len);
+        for (int k = 0; k < len; k++) out[done + k] = (dpa_t){m[k], (int8_t)input_point};
+    }
+}
+
+void fir_process_array(fir_state_t *st, const dpa_array_t *in, dpa_array_t *out) {
+    const int n = in->length;
+    
+    if (in->point == st->input_point) {
+        fir_run(st, in->mantissa, out->mantissa, n);
+    } else {
+        int32_t m[FIR_CHUNK];
+        for (int done = 0; done < n; done += FIR_CHUNK) {
+            const int len = n - done < FIR_CHUNK ? n - done : FIR_CHUNK;
+            dpa_array_copy_at(in, done, len, st->input_point, m);
+            fir_run(st, m, out->mantissa + done, len);
+        }
+    }
+    out->length = n;
+    out->point = st->input_point;
+}
+
+dpa_t fir_filter(fir_state_t *st, dpa_t input) {
+    dpa_t output;
+    fir_process_block(st, &input, &output, 1);
+    return output;
+}
+
+// ============================================================================
+// POLYPHASE DECIMATOR / INTERPOLATOR
+// ============================================================================
+
+int fir_decimator_init(fir_decimator_t *d, const fir_design_t *design, int factor,
+                       int input_point) {
+    if (factor < 1 || factor > FIR_MAX_FACTOR) return -1;
+    if (fir_init(&d->fir, design, input_point) != 0) return -1;
+    
+    d->factor = factor;
+    d->phase = 0;
+    return 0;
+}
+
+void fir_decimator_reset(fir_decimator_t *d) {
+    fir_reset(&d->fir);
+    d->phase = 0;
+}
+
+// Core loop of the decimator on mantissas at the input point; returns the
+// number of outputs written (in and out may alias)
+static int fir_decimate_run(fir_decimator_t *d, const int32_t *in, int32_t *out, int n) {
+    fir_state_t *st = &d->fir;
+    const int taps = st->taps;
+    const int drop = -st->coeff_point;
+    int index = st->index;
+    int phase = d->phase;
+    int produced = 0;
+    
+    for (int s = 0; s < n; s++) {
+        index = fir_push(st->delay, index, taps, in[s]);
+        
+        // Only every factor-th output is kept, so only that one is computed
+        if (++phase < d->factor) continue;
+        phase = 0;
+        
+        int64_t acc = fir_dot(st->coeffs, &st->delay[index + 1], taps, st->symmetry);
+        out[produced++] = fir_normalise(acc, drop, st->mode);
+    }
+    
+    st->index = index;
+    d->phase = phase;
+    return produced;
+}
+
+int fir_decimate_block(fir_decimator_t *d, const dpa_t *in, dpa_t *out, int n) {
+    const int input_point = d->fir.input_point;
+    int32_t m[FIR_CHUNK];
+    int produced = 0;
+    
+    for (int done = 0; done < n; done += FIR_CHUNK) {
+        const int len = n - done < FIR_CHUNK ? n - done : FIR_CHUNK;
+        for (int k = 0; k < len; k++) m[k] = dpa_mantissa_at(in[done + k], input_point);
+        const int kept = fir_decimate_run(d, m, m, len);
+        for (int k = 0; k < kept; k++) out[produced + k] = (dpa_t){m[k], (int8_t)input_point};
+        produced += kept;
+    }
+    return produced;
+}
+
+int fir_decimate_array(fir_decimator_t *d, const dpa_array_t *in, dpa_array_t *out) {
+    const int n = in->length;
+    int produced = 0;
+    
+    if (in->point == d->fir.input_point) {
+        produced = fir_decimate_run(d, in->mantissa, out->mantissa, n);
+    } else {
+        int32_t m[FIR_CHUNK];
+        for (int done = 0; done < n; done += FIR_CHUNK) {
+            const int len = n - done < FIR_CHUNK ? n - done : FIR_CHUNK;
+            dpa_array_copy_at(in, done, len, d->fir.input_point, m);
+            produced += fir_decimate_run(d, m, out->mantissa + produced, len);
+        }
+    }
+    out->length = produced;
+    out->point = d->fir.input_point;
+    return produced;
+}
+
+int fir_interpolator_init(fir_interpolator_t *ip, const fir_design_t *design, int factor,
+                          int input_point) {
+    const int taps = design->taps;
+    
+    if (factor < 1 || factor > FIR_MAX_FACTOR) return -1;
+    if (taps < 1 || taps > FIR_MAX_TAPS) return -1;
+    
+    int32_t mantissas[FIR_MAX_TAPS];
+    int point = fir_load_coeffs(design, mantissas);
+    if (point > 0) return -1;
+    
+    // Phase p uses h[p], h[p + L], h[p + 2L], ... (zero-padded to subtaps),
+    // stored reversed like fir_state_t so each phase is one dot product
+    const int subtaps = (taps + factor - 1) / factor;
+    for (int p = 0; p < factor; p++) {
+        int32_t *phase_coeffs = &ip->coeffs[p * subtaps];
+        for (int k = 0; k < subtaps; k++) {
+            int i = p + k * factor;
+            phase_coeffs[subtaps - 1 - k] = i < taps ? mantissas[i] : 0;
+        }
+    }
+    
+    ip->factor = factor;
+    ip->subtaps = subtaps;
+    ip->mode = design->mode;
+    ip->coeff_point = (int8_t)point;
+    ip->input_point = (int8_t)input_point;
+    fir_interpolator_reset(ip);
+    
+    return 0;
+}
+
+void fir_interpolator_reset(fir_interpolator_t *ip) {
+    memset(ip->delay, 0, sizeof(ip->delay));
+    ip->index = 0;
+}
+
+int fir_interpolate_block(fir_interpolator_t *ip, const dpa_t *in, dpa_t *out, int n) {
+    const int factor = ip->factor;
+    const int subtaps = ip->subtaps;
+    const int input_point = ip->input_point;
+    const int drop = -ip->coeff_point;
+    int index = ip->index;
+    int produced = 0;
+    
+    for (int s = 0; s < n; s++) {
+        index = fir_push(ip->delay, index, subtaps, dpa_mantissa_at(in[s], input_point));
+        const int32_t *window = &ip->delay[index + 1];
+        
+        // The zero-stuffed samples are never multiplied: each output phase
+        // only sees the real input samples through its own sub-filter
+        for (int p = 0; p < factor; p++) {
+            int64_t acc = fir_dot(&ip->coeffs[p * subtaps], window, subtaps, FIR_GENERAL);
+            out[produced++] = (dpa_t){fir_normalise(acc, drop, ip->mode),
+                                      (int8_t)input_point};
+        }
+    }
+    
+    ip->index = index;
+    return produced;
+}
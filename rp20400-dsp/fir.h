@@ -0,0 +1,156 @@
+/*
+ * Per-channel FIR filters in block-exponent DPA
+ *
+ * Each fir_state_t owns its delay line, position and coefficient set, so
+ * channels are independent units of work: they can be filtered in any
+ * order, in blocks, or on different cores.
+ *
+ * Coefficients are brought to one common point at init and the delay line
+ * holds raw mantissas at the state's input point, so every tap is a plain
+ * int32 x int32 -> int64 MAC and the point is applied once per output.
+ *
+ * The delay line is mirrored: each sample is written at index and at
+ * index + taps, so the newest `taps` samples always sit contiguously in
+ * delay[index + 1 .. index + taps]. With the coefficients stored in
+ * reverse, each output is a straight dot product with no wrap or modulo.
+ *
+ * A design picks the mode the coefficients are held in. DPA_DECIMAL keeps
+ * them at a decimal point, exactly as given, and drops digits from every
+ * output by a 64-bit division. DPA_BINARY rescales them once at init to a
+ * binary point, so the per-output normalisation is a rounding shift; the
+ * samples themselves stay at the decimal input point either way.
+ */
+
+#ifndef FIR_H
+#define FIR_H
+
+#include "dsp.h"
+#include "dpa2.h"
+#include "dpa_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest filter a fir_state_t can hold
+#ifndef FIR_MAX_TAPS
+#define FIR_MAX_TAPS       128
+#endif
+
+// Coefficient symmetry of a linear-phase design, h[i] = +/- h[taps-1-i].
+// Works for odd and even tap counts. The symmetric kernels pre-add the
+// mirrored samples in int32, so inputs need |mantissa| < 2^30.
+typedef enum {
+    FIR_GENERAL,        // no symmetry assumed
+    FIR_SYMMETRIC,      // h[i] =  h[taps-1-i]  (type I / II)
+    FIR_ANTISYMMETRIC   // h[i] = -h[taps-1-i]  (type III / IV)
+} fir_symmetry_t;
+
+// Filter descriptor. mode defaults to DPA_DECIMAL when left out of an
+// initialiser.
+typedef struct {
+    const dpa_t    *coeffs;
+    int             taps;
+    fir_symmetry_t  symmetry;
+    dpa_mode_t      mode;
+} fir_design_t;
+
+// In DPA_BINARY mode the largest coefficient is scaled to this many bits,
+// which keeps FIR_MAX_TAPS symmetric taps on 2^30 inputs inside int64
+#define FIR_COEFF_BITS     24
+
+// Largest decimation / interpolation factor
+#ifndef FIR_MAX_FACTOR
+#define FIR_MAX_FACTOR     16
+#endif
+
+typedef struct {
+    int32_t        coeffs[FIR_MAX_TAPS];       // reversed coefficient mantissas at coeff_point
+    int32_t        delay[2 * FIR_MAX_TAPS];    // mirrored input mantissas at input_point
+    int            taps;
+    int            index;                      // newest sample is at index + taps
+    fir_symmetry_t symmetry;
+    dpa_mode_t     mode;
+    int8_t         coeff_point;                // decimal or binary, by mode
+    int8_t         input_point;                // also the output point
+} fir_state_t;
+
+// Low-pass (Fs=8kHz, Fc=1kHz) used by the pipeline
+extern const dpa_t fir_coeffs[FIR_TAPS];
+
+// Set up a filter from a design (taps <= FIR_MAX_TAPS). Samples are
+// filtered at input_point. The finest point among the coefficients must be
+// <= 0 and >= -18 (DPA_DECIMAL, where it is the coefficient point) or
+// >= -9 (DPA_BINARY), and no coefficient may sit more than 9 digits above
+// it. A declared symmetry is checked against the coefficients and selects
+// the half-multiply kernel where the vector backend gains from it.
+// Returns 0, or -1 if the filter does not fit or is not as declared.
+int fir_init(fir_state_t *st, const fir_design_t *design, int input_point);
+
+// Clear the delay line, keeping the coefficients
+void fir_reset(fir_state_t *st);
+
+// Filter one sample
+dpa_t fir_filter(fir_state_t *st, dpa_t input);
+
+// Filter n samples. Outputs are rounded to the state's input point.
+// in and out may alias.
+void fir_process_block(fir_state_t *st, const dpa_t *in, dpa_t *out, int n);
+
+// Same on a shared-point array: out gets in->length mantissas at the
+// input point. An input already at that point is filtered straight from
+// its mantissas. in and out may share storage.
+void fir_process_array(fir_state_t *st, const dpa_array_t *in, dpa_array_t *out);
+
+// ============================================================================
+// POLYPHASE DECIMATOR / INTERPOLATOR
+// ============================================================================
+
+// Decimate by M: every input enters the delay line but only every M-th
+// output is computed, so the cost per input is taps/M multiplies.
+typedef struct {
+    fir_state_t fir;
+    int         factor;     // M
+    int         phase;      // inputs since the last output
+} fir_decimator_t;
+
+// Interpolate by L: the design is split into L polyphase sub-filters of
+// ceil(taps/L) taps that run on the input-rate delay line, so the
+// zero-stuffed samples are never multiplied. The passband gain of the
+// design should be L to keep the signal level.
+typedef struct {
+    int32_t coeffs[FIR_MAX_TAPS + FIR_MAX_FACTOR];  // per phase, reversed
+    int32_t delay[2 * FIR_MAX_TAPS];                // mirrored, input rate
+    int     factor;     // L
+    int     subtaps;    // ceil(taps / L)
+    int     index;
+    dpa_mode_t mode;
+    int8_t  coeff_point;
+    int8_t  input_point;
+} fir_interpolator_t;
+
+// Both inits return 0, or -1 for an unsupported design or factor
+// (1 <= factor <= FIR_MAX_FACTOR). The decimator honours a declared
+// symmetry; the interpolator sub-filters are always general.
+int fir_decimator_init(fir_decimator_t *d, const fir_design_t *design, int factor,
+                       int input_point);
+void fir_decimator_reset(fir_decimator_t *d);
+
+// Consume n inputs, write the outputs they complete; returns the number
+// written (n/M give or take one). in and out may alias. The array form
+// consumes in->length inputs and sets out->length to the count.
+int fir_decimate_block(fir_decimator_t *d, const dpa_t *in, dpa_t *out, int n);
+int fir_decimate_array(fir_decimator_t *d, const dpa_array_t *in, dpa_array_t *out);
+
+int fir_interpolator_init(fir_interpolator_t *ip, const fir_design_t *design, int factor,
+                          int input_point);
+void fir_interpolator_reset(fir_interpolator_t *ip);
+
+// Consume n inputs and write n * L outputs; returns n * L
+int fir_interpolate_block(fir_interpolator_t *ip, const dpa_t *in, dpa_t *out, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIR_H
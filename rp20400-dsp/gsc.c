@@ -0,0 +1,175 @@
+/*
+ * Adaptive beamforming: generalised sidelobe canceller (GSC) in DPA
+ */
+
+#include <string.h>
+#include "gsc.h"
+#include "dpa_vec.h"
+
+// Weight updates are step * reference / GSC_STEP_SCALE, a constant so the
+// per-tap rounding compiles to a multiply
+#define GSC_STEP_SCALE      1000000000
+#define GSC_STEP_DIGITS     9
+
+// Filter output digits dropped per sample (10^-GSC_WEIGHT_POINT)
+#define GSC_WEIGHT_SCALE    100000000
+#if GSC_WEIGHT_POINT != -8
+#error "GSC_WEIGHT_SCALE must be 10^-GSC_WEIGHT_POINT"
+#endif
+
+static inline int32_t gsc_saturate(int64_t v) {
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < INT32_MIN) return INT32_MIN;
+    return (int32_t)v;
+}
+
+// Round-to-nearest num / scale for scale > 0
+// (half away from zero; the bias select keeps the loops branch-free)
+#define GSC_ROUND(num, scale) \
+    (((num) + ((num) < 0 ? -((scale) / 2) : (scale) / 2)) / (scale))
+
+// round(num * 10^exp / den) for den > 0, saturated to int32. num is scaled
+// up while it fits and den scaled down for the rest, so the quotient keeps
+// about nine significant digits whatever the signal level.
+static int32_t gsc_quotient(int64_t num, int64_t den, int exp) {
+    int64_t mag = num < 0 ? -num : num;
+    int grow = 0;
+
+    if (exp > 0) {
+        // Multiplies only: find how many digits num can take
+        while (grow < exp && mag < INT64_MAX / 20) {
+            mag *= 10;
+            grow++;
+        }
+        num *= dpa_pow10_64[grow];
+
+        int shrink = exp - grow;
+        if (shrink > DPA_POW10_64_MAX) return 0;
+        if (shrink > 0) {
+            den = GSC_ROUND(den, dpa_pow10_64[shrink]);
+            if (den == 0) return num < 0 ? INT32_MIN : INT32_MAX;
+        }
+    } else if (exp < 0) {
+        if (-exp > DPA_POW10_64_MAX) return 0;
+        num = GSC_ROUND(num, dpa_pow10_64[-exp]);
+    }
+
+    return gsc_saturate(GSC_ROUND(num, den));
+}
+
+int gsc_init(gsc_t *g, int num_sensors, int taps, dpa_t mu, dpa_t eps, int update_interval,
+             int data_point) {
+    if (num_sensors < 2 || num_sensors > BEAM_MAX_SENSORS) return -1;
+    if (taps < 1 || taps > GSC_MAX_TAPS || update_interval < 1) return -1;
+    if (mu.mantissa <= 0 || eps.mantissa < 0) return -1;
+    // mu < 2: any positive mantissa at a point above 0 is at least 10
+    if (mu.point > 0) return -1;
+    if (-mu.point <= DPA_POW10_32_MAX && mu.mantissa >= 2 * (int64_t)dpa_pow10_32[-mu.point]) {
+        return -1;
+    }
+
+    g->num_refs = num_sensors - 1;
+    g->taps = taps;
+    g->update_interval = update_interval;
+    g->mu = mu;
+
+    // eps in squared data units, brought to 2 * data_point
+    int shift = eps.point - 2 * data_point;
+    if (shift < 0 || shift > DPA_POW10_64_MAX) return -1;
+    g->eps = (int64_t)eps.mantissa * dpa_pow10_64[shift];
+
+    g->data_point = (int8_t)data_point;
+    gsc_reset(g);
+    return 0;
+}
+
+void gsc_reset(gsc_t *g) {
+    memset(g->weights, 0, sizeof(g->weights));
+    memset(g->refs, 0, sizeof(g->refs));
+    memset(g->main_delay, 0, sizeof(g->main_delay));
+    g->index = g->taps - 1;
+    g->main_index = 0;
+    g->power = 0;
+    g->countdown = g->update_interval;
+}
+
+// NLMS: w += mu * e * u / (eps + |u|^2) for every weight
+static void gsc_adapt(gsc_t *g, int32_t error) {
+    // mu * e / (eps + power) is a plain number at 10^(mu.point - data_point)
+    // in mantissas; as a step whose product with a reference mantissa,
+    // over GSC_STEP_SCALE, is a weight change at GSC_WEIGHT_POINT, it
+    // gains a further 10^(data_point - GSC_WEIGHT_POINT + GSC_STEP_DIGITS)
+    int exp = g->mu.point - GSC_WEIGHT_POINT + GSC_STEP_DIGITS;
+    int64_t step = gsc_quotient((int64_t)g->mu.mantissa * error, g->eps + g->power, exp);
+    if (step == 0) return;
+
+    for (int r = 0; r < g->num_refs; r++) {
+        const int32_t *window = &g->refs[r][g->index + 1];
+        int32_t *w = g->weights[r];
+
+        for (int j = 0; j < g->taps; j++) {
+            int64_t delta = step * window[j];
+            w[j] = gsc_saturate(w[j] + GSC_ROUND(delta, GSC_STEP_SCALE));
+        }
+    }
+}
+
+void gsc_process_array(gsc_t *g, beamformer_t *bf, const beam_steering_t *steer,
+                       dpa_array_t *out) {
+    int32_t (*aligned)[BEAM_MAX_BLOCK] = g->aligned;
+    dpa_array_t fixed = dpa_array(g->fixed, 0, 0);
+    const int taps = g->taps;
+    const int main_len = taps / 2;
+
+    beam_form_array(bf, steer, &fixed);
+    for (int s = 0; s <= g->num_refs; s++) {
+        beam_align(bf, steer, s, aligned[s]);
+    }
+
+    for (int i = 0; i < bf->block_len; i++) {
+        // Blocking branch: push the adjacent differences, keeping the
+        // window power current by adding the new square and removing the
+        // oldest one
+        if (++g->index == taps) g->index = 0;
+        for (int r = 0; r < g->num_refs; r++) {
+            int32_t *line = g->refs[r];
+            int32_t u = aligned[r + 1][i] - aligned[r][i];
+            int32_t old = line[g->index];
+
+            g->power += (int64_t)u * u - (int64_t)old * old;
+            line[g->index] = u;
+            line[g->index + taps] = u;
+        }
+
+        // Main path, delayed to the centre of the adaptive window
+        int32_t d = fixed.mantissa[i];
+        if (main_len > 0) {
+            int32_t delayed = g->main_delay[g->main_index];
+            g->main_delay[g->main_index] = d;
+            if (++g->main_index == main_len) g->main_index = 0;
+            d = delayed;
+        }
+
+        int64_t acc = 0;
+        for (int r = 0; r < g->num_refs; r++) {
+            acc += dpa_dot_i32(g->weights[r], &g->refs[r][g->index + 1], taps);
+        }
+
+        int32_t y = gsc_saturate((int64_t)d - GSC_ROUND(acc, GSC_WEIGHT_SCALE));
+        out->mantissa[i] = y;
+
+        if (--g->countdown == 0) {
+            g->countdown = g->update_interval;
+            gsc_adapt(g, y);
+        }
+    }
+    out->length = bf->block_len;
+    out->point = g->data_point;
+}
+
+void gsc_process(gsc_t *g, beamformer_t *bf, const beam_steering_t *steer, dpa_t *out) {
+    dpa_array_t y = dpa_array(g->output, 0, 0);
+
+    gsc_process_array(g, bf, steer, &y);
+    dpa_array_to_dpa(&y, out);
+}
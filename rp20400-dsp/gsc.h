@@ -0,0 +1,78 @@
+/*
+ * Adaptive beamforming: generalised sidelobe canceller (GSC) in DPA
+ *
+ * The fixed delay-and-sum beam toward the look direction is the main path.
+ * Differences of adjacent steered sensors form the blocking branch: a
+ * plane wave from the look direction arrives aligned on every sensor and
+ * cancels there, so the branch carries only interference. One adaptive
+ * FIR per difference signal, trained with normalised LMS, predicts the
+ * interference left in the main path and subtracts it.
+ *
+ * Everything is integer: references and output are mantissas at the
+ * beamformer's data point, weights are mantissas at GSC_WEIGHT_POINT and
+ * the NLMS step is one decimal quotient per update. Updating only every
+ * update_interval samples trades convergence speed for cycles.
+ */
+
+#ifndef GSC_H
+#define GSC_H
+
+#include "beamform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GSC_MAX_TAPS        16
+#define GSC_MAX_REFS        (BEAM_MAX_SENSORS - 1)
+#define GSC_WEIGHT_POINT    (-8)
+
+typedef struct {
+    int     num_refs;           // num_sensors - 1 blocking outputs
+    int     taps;               // adaptive taps per blocking output
+    int     update_interval;    // adapt once every this many samples
+    int     countdown;
+    dpa_t   mu;                 // NLMS step size, 0 < mu < 2
+    int64_t eps;                // regularisation, at 2 * data_point
+
+    int32_t weights[GSC_MAX_REFS][GSC_MAX_TAPS];        // oldest sample first
+    int32_t refs[GSC_MAX_REFS][2 * GSC_MAX_TAPS];       // mirrored delay lines
+    int     index;
+    int64_t power;              // sum of squares over every reference window
+
+    // Main path delayed by taps / 2 so the adaptive filters can reach
+    // both sides of it
+    int32_t main_delay[GSC_MAX_TAPS];
+    int     main_index;
+
+    int8_t  data_point;
+
+    // Each sensor of the current block steered by beam_align, the fixed
+    // beam, and gsc_process's output before it is expanded to dpa_t
+    int32_t aligned[BEAM_MAX_SENSORS][BEAM_MAX_BLOCK];
+    int32_t fixed[BEAM_MAX_BLOCK];
+    int32_t output[BEAM_MAX_BLOCK];
+} gsc_t;
+
+// Set up a canceller for num_sensors (2..BEAM_MAX_SENSORS) sensors with
+// `taps` (1..GSC_MAX_TAPS) adaptive taps per blocking output, step size
+// mu (0 < mu < 2), regulariser eps (a power, in squared data units) and one update
+// every update_interval samples. Returns 0, or -1 for a bad configuration.
+int gsc_init(gsc_t *g, int num_sensors, int taps, dpa_t mu, dpa_t eps, int update_interval,
+             int data_point);
+
+// Zero the weights and delay lines
+void gsc_reset(gsc_t *g);
+
+// Run the block loaded in bf, steered by steer, through the canceller:
+// block_len output samples at data_point. bf must have been set up with
+// num_sensors sensors and data_point.
+void gsc_process(gsc_t *g, beamformer_t *bf, const beam_steering_t *steer, dpa_t *out);
+void gsc_process_array(gsc_t *g, beamformer_t *bf, const beam_steering_t *steer,
+                       dpa_array_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GSC_H
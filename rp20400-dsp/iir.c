@@ -0,0 +1,98 @@
+/*
+ * Biquad IIR cascades in block-exponent DPA
+ */
+
+#include <string.h>
+#include "iir.h"
+
+int iir_init(iir_cascade_t *c, const iir_biquad_t *design, int num_sections,
+             iir_form_t form, int data_point) {
+    if (num_sections < 1 || num_sections > IIR_MAX_SECTIONS) return -1;
+    
+    for (int k = 0; k < num_sections; k++) {
+        const iir_biquad_t *d = &design[k];
+        const dpa_t coeffs[5] = {d->b0, d->b1, d->b2, d->a1, d->a2};
+        
+        int point = coeffs[0].point, coarsest = coeffs[0].point;
+        for (int i = 1; i < 5; i++) {
+            if (coeffs[i].point < point) point = coeffs[i].point;
+            if (coeffs[i].point > coarsest) coarsest = coeffs[i].point;
+        }
+        if (point > 0 || point < -DPA_POW10_64_MAX) return -1;
+        if (coarsest - point > DPA_POW10_32_MAX) return -1;
+        
+        iir_section_t *s = &c->sections[k];
+        for (int i = 0; i < 3; i++) s->b[i] = dpa_mantissa_at(coeffs[i], point);
+        for (int i = 0; i < 2; i++) s->a[i] = dpa_mantissa_at(coeffs[3 + i], point);
+        s->coeff_point = (int8_t)point;
+    }
+    
+    c->num_sections = num_sections;
+    c->form = form;
+    c->data_point = (int8_t)data_point;
+    iir_reset(c);
+    
+    return 0;
+}
+
+void iir_reset(iir_cascade_t *c) {
+    for (int k = 0; k < c->num_sections; k++) {
+        iir_section_t *s = &c->sections[k];
+        s->x1 = s->x2 = s->y1 = s->y2 = 0;
+        s->residue = 0;
+        s->s1 = s->s2 = 0;
+    }
+}
+
+// Symmetric like dpa_normalise64_flags, so a saturated output can be negated
+static inline int32_t iir_saturate(int64_t v) {
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < -INT32_MAX) return -INT32_MAX;
+    return (int32_t)v;
+}
+
+static inline int32_t iir_df1(iir_section_t *s, int32_t x) {
+    const int digits = -s->coeff_point;
+    
+    int64_t acc = (int64_t)s->b[0] * x + (int64_t)s->b[1] * s->x1 + (int64_t)s->b[2] * s->x2
+                - (int64_t)s->a[0] * s->y1 - (int64_t)s->a[1] * s->y2;
+    
+    // Fraction saving: carry what rounding dropped into the next output.
+    // A clipped output drops the residue instead, which would otherwise
+    // hold the clipped excess and wind up for as long as y saturates.
+    acc += s->residue;
+    const int64_t rounded = dpa_round_digits64(acc, digits);
+    int32_t y = iir_saturate(rounded);
+    s->residue = y == rounded ? acc - (int64_t)y * dpa_pow10_64[digits] : 0;
+    
+    s->x2 = s->x1;
+    s->x1 = x;
+    s->y2 = s->y1;
+    s->y1 = y;
+    return y;
+}
+
+static inline int32_t iir_tdf2(iir_section_t *s, int32_t x) {
+    int32_t y = iir_saturate(dpa_round_digits64((int64_t)s->b[0] * x + s->s1, -s->coeff_point));
+    
+    s->s1 = (int64_t)s->b[1] * x - (int64_t)s->a[0] * y + s->s2;
+    s->s2 = (int64_t)s->b[2] * x - (int64_t)s->a[1] * y;
+    return y;
+}
+
+void iir_process_block(iir_cascade_t *c, const dpa_t *in, dpa_t *out, int n) {
+    const int data_point = c->data_point;
+    const int num_sections = c->num_sections;
+    
+    for (int i = 0; i < n; i++) {
+        int32_t v = dpa_mantissa_at(in[i], data_point);
+        
+        if (c->form == IIR_DF1) {
+            for (int k = 0; k < num_sections; k++) v = iir_df1(&c->sections[k], v);
+        } else {
+            for (int k = 0; k < num_sections; k++) v = iir_tdf2(&c->sections[k], v);
+        }
+        
+        out[i] = (dpa_t){v, (int8_t)data_point};
+    }
+}
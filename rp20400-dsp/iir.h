@@ -0,0 +1,82 @@
+/*
+ * Biquad IIR cascades in block-exponent DPA
+ *
+ * Each second-order section
+ *     y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ * keeps its five coefficients as mantissas at one per-section point (the
+ * finest point among them), while the signal stays at the cascade's data
+ * point throughout. Products accumulate in int64 and are rounded back to
+ * the data point once per section output.
+ *
+ * Two structures:
+ *   IIR_DF1  - Direct Form I on data-point samples; the rounding remainder
+ *              is fed into the next output (fraction saving), which keeps
+ *              the quantisation noise out of the feedback and suppresses
+ *              zero-input limit cycles.
+ *   IIR_TDF2 - Transposed Direct Form II with int64 states at the product
+ *              point, so only the output is ever rounded.
+ */
+
+#ifndef IIR_H
+#define IIR_H
+
+#include "dpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef IIR_MAX_SECTIONS
+#define IIR_MAX_SECTIONS   8
+#endif
+
+typedef enum {
+    IIR_DF1,
+    IIR_TDF2
+} iir_form_t;
+
+// One section as designed (a0 normalised to 1)
+typedef struct {
+    dpa_t b0, b1, b2;
+    dpa_t a1, a2;
+} iir_biquad_t;
+
+typedef struct {
+    int32_t b[3];           // b0, b1, b2 mantissas at coeff_point
+    int32_t a[2];           // a1, a2 mantissas at coeff_point
+    int8_t  coeff_point;    // this section's block exponent
+    
+    // DF-I state: past inputs/outputs at the data point, rounding remainder
+    int32_t x1, x2, y1, y2;
+    int64_t residue;
+    
+    // TDF-II state: wide, at coeff_point + data point
+    int64_t s1, s2;
+} iir_section_t;
+
+typedef struct {
+    iir_section_t sections[IIR_MAX_SECTIONS];
+    int           num_sections;
+    iir_form_t    form;
+    int8_t        data_point;   // input, inter-section and output point
+} iir_cascade_t;
+
+// Set up a cascade of num_sections biquads. Each section's coefficient
+// point must be in [-DPA_POW10_64_MAX, 0], with no coefficient more than
+// DPA_POW10_32_MAX digits above it (as for fir_init). Returns 0, or -1 if
+// the design does not fit.
+int iir_init(iir_cascade_t *c, const iir_biquad_t *design, int num_sections,
+             iir_form_t form, int data_point);
+
+// Clear all section states, keeping the coefficients
+void iir_reset(iir_cascade_t *c);
+
+// Filter n samples through every section. Outputs are at the data point
+// and saturate at +-INT32_MAX. in and out may alias.
+void iir_process_block(iir_cascade_t *c, const dpa_t *in, dpa_t *out, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IIR_H
@@ -3,8 +3,9 @@
  * 
  * Features:
  * - FIR filtering with exact integer arithmetic
- * - Basic FFT using DPA (power-of-2 sizes)
- * - Simple beamforming for multiple sensors
+ * - In-place radix-2 FFT using DPA (power-of-2 sizes 16..4096)
+ * - Fractional-delay beamforming steerable to any angle, optionally
+ *   adaptive (GSC with NLMS) to null interferers
  * - ADC input sampling
  * - No floating-point operations required!
  * 
@@ -19,111 +20,58 @@
 #include "hardware/dma.h"
 #include "hardware/irq.h"
 #include "hardware/timer.h"
+#include "pico/multicore.h"
+#include "pipeline.h"
 
-// ============================================================================
-// DPA CORE IMPLEMENTATION for microcontroller)
-// ============================================================================
-
-typedef struct {
-    int32_t mantissa;   // 32-bit for microcontroller efficiency
-    int8_t  point;      // Decimal point position
-} dpa_t;
-
-// Basic DPA operations optimized for RP2040
-static inline dpa_t dpa_add(dpa_t a, dpa_t b) {
-    if (a.point == b.point) {
-        return (dpa_t){a.mantissa + b.mantissa, a.point};
-    }
-    
-    if (a.point > b.point) {
-        int shift = a.point - b.point;
-        if (shift > 10) return a; // Avoid overflow
-        int32_t scale = 1;
-        for (int i = 0; i < shift; i++) scale *= 10;
-        return (dpa_t){a.mantissa + b.mantissa * scale, a.point};
-    } else {
-        int shift = b.point - a.point;
-        if (shift > 10) return b;
-        int32_t scale = 1;
-        for (int i = 0; i < shift; i++) scale *= 10;
-        return (dpa_t){a.mantissa * scale + b.mantissa, b.point};
-    }
-}
-
-static inline dpa_t dpa_multiply(dpa_t a, dpa_t b) {
-    // Use 64-bit intermediate to avoid overflow
-    int64_t result = (int64_t)a.mantissa * b.mantissa;
-    
-    // Check for overflow and scale down if needed
-    if (result > INT32_MAX || result < INT32_MIN) {
-        result /= 1000;
-        return (dpa_t){(int32_t)result, a.point + b.point + 3};
-    }
-    
-    return (dpa_t){(int32_t)result, a.point + b.point};
-}
-
-static inline dpa_t dpa_from_int(int32_t value, int decimal_places) {
-    int32_t scale = 1;
-    for (int i = 0; i < decimal_places; i++) scale *= 10;
-    return (dpa_t){value * scale, -decimal_places};
-}
+// Number of DMA capture buffers chained in a ring. While one is being
+// processed the DMA keeps filling the next, so the ADC never stops.
+#define CAPTURE_BUFFERS    2
 
-static inline int32_t dpa_to_int(dpa_t num) {
-    if (num.point >= 0) {
-        int32_t scale = 1;
-        for (int i = 0; i < num.point; i++) scale *= 10;
-        return num.mantissa * scale;
-    } else {
-        int32_t scale = 1;
-        for (int i = 0; i < -num.point; i++) scale *= 10;
-        return num.mantissa / scale;
-    }
-}
-
-// ============================================================================
-// DSP CONFIGURATION
-// ============================================================================
-
-#define SAMPLE_RATE_HZ      8000
-#define BUFFER_SIZE         256
-#define FIR_TAPS           32
-#define FFT_SIZE           64
-#define NUM_SENSORS        4
-#define ADC_CHANNELS       3  // Use ADC0, ADC1, ADC2
+// Run demux/FIR on core0 and beamforming/FFT on core1. With 0 both
+// pipeline stages run back to back on core0.
+#ifndef DSP_DUAL_CORE
+#define DSP_DUAL_CORE      1
+#endif
 
 // ADC and processing buffers
-static uint16_t adc_buffer[ADC_CHANNELS][BUFFER_SIZE];
-static dpa_t    signal_buffer[ADC_CHANNELS][BUFFER_SIZE];
-static dpa_t    output_buffer[BUFFER_SIZE];
-
-// FIR filter coefficients (low-pass, Fs=8kHz, Fc=1kHz)
-// Pre-converted to DPA format for efficiency
-static const dpa_t fir_coeffs[FIR_TAPS] = {
-    {-41, -6},   {-134, -6},  {-207, -6},  {-180, -6},
-    {-12, -6},   {244, -6},   {494, -6},   {583, -6},
-    {394, -6},   {-67, -6},   {-693, -6},  {-1266, -6},
-    {-1528, -6}, {-1246, -6}, {-434, -6},  {1116, -6},
-    {3395, -6},  {6251, -6},  {9367, -6},  {12358, -6},
-    {14808, -6}, {16371, -6}, {16763, -6}, {15808, -6},
-    {13459, -6}, {9806, -6},  {5081, -6},  {-331, -6},
-    {-5806, -6}, {-10646, -6},{-14308, -6},{-16540, -6}
-};
-
-// FIR filter delay line
-static dpa_t fir_delay[ADC_CHANNELS][FIR_TAPS];
-static int fir_index = 0;
+// Each adc_buffer holds a round-robin capture interleaved as ch0, ch1, ch2, ...
+static uint16_t adc_buffer[CAPTURE_BUFFERS][BUFFER_SIZE * ADC_CHANNELS];
 
 // ============================================================================
 // ADC SAMPLING SETUP
 // ============================================================================
 
-static int dma_chan;
-static bool sampling_complete = false;
+static int dma_chans[CAPTURE_BUFFERS];
+
+// Block counters: the IRQ advances blocks_captured, the main loop advances
+// blocks_processed once it is done with a buffer. Both only ever increase,
+// so their difference is the number of filled buffers not yet consumed.
+static volatile uint32_t blocks_captured = 0;
+static volatile uint32_t blocks_processed = 0;
+
+// Overrun counters: capture_overruns counts blocks where the DMA started
+// refilling a buffer the DSP had not released yet; blocks_dropped counts
+// blocks the main loop skipped to catch up.
+static volatile uint32_t capture_overruns = 0;
+static uint32_t blocks_dropped = 0;
 
 void dma_handler() {
-    dma_hw->ints0 = 1u << dma_chan;
-    sampling_complete = true;
+    for (int i = 0; i < CAPTURE_BUFFERS; i++) {
+        if (!(dma_hw->ints0 & (1u << dma_chans[i]))) continue;
+        dma_hw->ints0 = 1u << dma_chans[i];
+        
+        // Re-arm this channel for its next turn in the chain; the channel
+        // chained after it is already running
+        dma_channel_set_write_addr(dma_chans[i], adc_buffer[i], false);
+        dma_channel_set_trans_count(dma_chans[i], BUFFER_SIZE * ADC_CHANNELS, false);
+        
+        blocks_captured++;
+        
+        // The buffer now being filled still holds an unprocessed block
+        if (blocks_captured - blocks_processed > CAPTURE_BUFFERS - 1) {
+            capture_overruns++;
+        }
+    }
 }
 
 void setup_adc_sampling() {
@@ -133,20 +81,28 @@ void setup_adc_sampling() {
     adc_gpio_init(27); // ADC1  
     adc_gpio_init(28); // ADC2
     
-    // Setup DMA for continuous ADC sampling
-    dma_chan = dma_claim_unused_channel(true);
-    dma_channel_config cfg = dma_channel_get_default_config(dma_chan);
-    
-    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
-    channel_config_set_read_increment(&cfg, false);
-    channel_config_set_write_increment(&cfg, true);
-    channel_config_set_dreq(&cfg, DREQ_ADC);
+    // Setup DMA ring for continuous ADC sampling: each channel fills its
+    // own buffer then chains to the next
+    for (int i = 0; i < CAPTURE_BUFFERS; i++) {
+        dma_chans[i] = dma_claim_unused_channel(true);
+    }
     
-    dma_channel_configure(dma_chan, &cfg,
-        adc_buffer[0], &adc_hw->fifo,
-        BUFFER_SIZE * ADC_CHANNELS, false);
+    for (int i = 0; i < CAPTURE_BUFFERS; i++) {
+        dma_channel_config cfg = dma_channel_get_default_config(dma_chans[i]);
+        
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, false);
+        channel_config_set_write_increment(&cfg, true);
+        channel_config_set_dreq(&cfg, DREQ_ADC);
+        channel_config_set_chain_to(&cfg, dma_chans[(i + 1) % CAPTURE_BUFFERS]);
+        
+        dma_channel_configure(dma_chans[i], &cfg,
+            adc_buffer[i], &adc_hw->fifo,
+            BUFFER_SIZE * ADC_CHANNELS, false);
+        
+        dma_channel_set_irq0_enabled(dma_chans[i], true);
+    }
     
-    dma_channel_set_irq0_enabled(dma_chan, true);
     irq_set_exclusive_handler(DMA_IRQ_0, dma_handler);
     irq_set_enabled(DMA_IRQ_0, true);
     
@@ -156,136 +112,68 @@ void setup_adc_sampling() {
     adc_set_clkdiv(48000000.0f / SAMPLE_RATE_HZ / ADC_CHANNELS - 1);
 }
 
+// Start continuous capture; the DMA ring keeps running from here on
 void start_sampling() {
-    sampling_complete = false;
-    dma_channel_start(dma_chan);
+    dma_channel_start(dma_chans[0]);
     adc_run(true);
 }
 
 // ============================================================================
-// FIR FILTER IMPLEMENTATION
+// PROCESSING PIPELINE
 // ============================================================================
 
-dpa_t fir_filter(int channel, dpa_t input) {
-    // Store new sample in circular buffer
-    fir_delay[channel][fir_index] = input;
+static void print_spectrum(const dsp_block_t *block) {
+    if (DECIMATED_SIZE < FFT_SIZE) return;
     
-    // Compute filter output using DPA arithmetic
-    dpa_t output = {0, 0};
-    
-    for (int i = 0; i < FIR_TAPS; i++) {
-        int delay_idx = (fir_index - i + FIR_TAPS) % FIR_TAPS;
-        dpa_t product = dpa_multiply(fir_coeffs[i], fir_delay[channel][delay_idx]);
-        output = dpa_add(output, product);
+    // Print first few FFT bins for debugging
+    printf("FFT bins: ");
+    for (int i = 0; i < 8; i++) {
+        int32_t magnitude = dpa_to_int((dpa_t){block->spectrum[i].re, block->spectrum_point});
+        printf("%ld ", (long)magnitude);
     }
-    
-    return output;
+    printf("\n");
 }
 
-// ============================================================================
-// BASIC FFT IMPLEMENTATION (POWER-OF-2 SIZES)
-// ============================================================================
+#if DSP_DUAL_CORE
 
-// Simple DFT for small sizes (more practical for microcontroller)
-void dpa_dft(dpa_t *input, dpa_t *real_out, dpa_t *imag_out, int N) {
-    // Pre-computed sine/cosine tables in DPA format
-    // For N=64, we need sin/cos values for k*2*pi/64
-    static const dpa_t cos_table[16] = {
-        {10000, -4}, {9808, -4}, {9239, -4}, {8315, -4},
-        {7071, -4}, {5556, -4}, {3827, -4}, {1951, -4},
-        {0, -4}, {-1951, -4}, {-3827, -4}, {-5556, -4},
-        {-7071, -4}, {-8315, -4}, {-9239, -4}, {-9808, -4}
-    };
-    
-    static const dpa_t sin_table[16] = {
-        {0, -4}, {1951, -4}, {3827, -4}, {5556, -4},
-        {7071, -4}, {8315, -4}, {9239, -4}, {9808, -4},
-        {10000, -4}, {9808, -4}, {9239, -4}, {8315, -4},
-        {7071, -4}, {5556, -4}, {3827, -4}, {1951, -4}
-    };
-    
-    for (int k = 0; k < N/2; k++) { // Only compute positive frequencies
-        real_out[k] = (dpa_t){0, 0};
-        imag_out[k] = (dpa_t){0, 0};
-        
-        for (int n = 0; n < N; n++) {
-            int angle_idx = (k * n * 16 / N) % 16;
-            
-            dpa_t cos_term = dpa_multiply(input[n], cos_table[angle_idx]);
-            dpa_t sin_term = dpa_multiply(input[n], sin_table[angle_idx]);
-            
-            real_out[k] = dpa_add(real_out[k], cos_term);
-            imag_out[k] = dpa_add(imag_out[k], sin_term);
-        }
-    }
-}
+static dsp_pipeline_t pipeline;
 
-// ============================================================================
-// SIMPLE BEAMFORMING
-// ============================================================================
+static void pipeline_wait() {
+    tight_loop_contents();
+}
 
-void delay_and_sum_beamforming(dpa_t input_channels[NUM_SENSORS][BUFFER_SIZE], 
-                              dpa_t *output, int samples) {
-    // Simple delay-and-sum beamforming
-    // Assumes sensors are in a line, steering toward 0 degrees
-    
-    static const int delays[NUM_SENSORS] = {0, 2, 4, 6}; // Sample delays
-    
-    for (int i = 0; i < samples; i++) {
-        output[i] = (dpa_t){0, 0};
-        
-        for (int ch = 0; ch < NUM_SENSORS && ch < ADC_CHANNELS; ch++) {
-            int delayed_idx = i - delays[ch];
-            if (delayed_idx >= 0) {
-                output[i] = dpa_add(output[i], input_channels[ch][delayed_idx]);
-            }
+// core1: back half of the pipeline
+static void core1_entry() {
+    while (true) {
+        dsp_block_t *block = pipeline_peek(&pipeline);
+        if (!block) {
+            tight_loop_contents();
+            continue;
         }
         
-        // Average by dividing by number of sensors
-        output[i].mantissa /= NUM_SENSORS;
+        pipeline_back(block);
+        print_spectrum(block);
+        pipeline_release(&pipeline);
     }
 }
 
-// ============================================================================
-// PROCESSING PIPELINE
-// ============================================================================
+void process_audio_block(const uint16_t *adc_samples) {
+    static uint32_t sequence = 0;
+    pipeline_push(&pipeline, adc_samples, sequence++, pipeline_wait);
+}
 
-void process_audio_block() {
-    // Convert ADC samples to DPA format
-    for (int ch = 0; ch < ADC_CHANNELS; ch++) {
-        for (int i = 0; i < BUFFER_SIZE; i++) {
-            // Convert 12-bit ADC to signed DPA with 4 decimal places
-            int32_t sample = (int32_t)adc_buffer[ch][i] - 2048; // Center around 0
-            signal_buffer[ch][i] = dpa_from_int(sample, 4);
-        }
-    }
-    
-    // Apply FIR filtering to each channel
-    for (int ch = 0; ch < ADC_CHANNELS; ch++) {
-        for (int i = 0; i < BUFFER_SIZE; i++) {
-            signal_buffer[ch][i] = fir_filter(ch, signal_buffer[ch][i]);
-            fir_index = (fir_index + 1) % FIR_TAPS;
-        }
-    }
-    
-    // Apply beamforming
-    delay_and_sum_beamforming(signal_buffer, output_buffer, BUFFER_SIZE);
+#else
+
+void process_audio_block(const uint16_t *adc_samples) {
+    static dsp_block_t block;
     
-    // Optional: Compute FFT of beamformed output
-    static dpa_t fft_real[FFT_SIZE], fft_imag[FFT_SIZE];
-    if (BUFFER_SIZE >= FFT_SIZE) {
-        dpa_dft(output_buffer, fft_real, fft_imag, FFT_SIZE);
-        
-        // Print first few FFT bins for debugging
-        printf("FFT bins: ");
-        for (int i = 0; i < 8; i++) {
-            int32_t magnitude = dpa_to_int(fft_real[i]);
-            printf("%ld ", (long)magnitude);
-        }
-        printf("\n");
-    }
+    pipeline_front(adc_samples, &block);
+    pipeline_back(&block);
+    print_spectrum(&block);
 }
 
+#endif
+
 // ============================================================================
 // MAIN PROGRAM
 // ============================================================================
@@ -297,32 +185,50 @@ int main() {
     printf("==========================\n");
     printf("Sample Rate: %d Hz\n", SAMPLE_RATE_HZ);
     printf("Buffer Size: %d samples\n", BUFFER_SIZE);
-    printf("FIR Taps: %d\n", FIR_TAPS);
+    printf("Decimation: %d\n", DECIMATION_FACTOR);
+    printf("FIR Taps: %d (%s)\n", FIR_TAPS, PIPELINE_DPA_MODE == DPA_BINARY ? "binary" : "decimal");
     printf("FFT Size: %d\n", FFT_SIZE);
-    printf("Channels: %d\n\n", ADC_CHANNELS);
+    printf("Channels: %d\n", ADC_CHANNELS);
+    printf("Beam Steering: %d deg\n\n", BEAM_STEER_DEG);
     
     // Initialize ADC and DMA
     setup_adc_sampling();
     
-    // Clear filter delay lines
-    memset(fir_delay, 0, sizeof(fir_delay));
+    // Set up the per-channel FIR filters and the beamformer
+    pipeline_front_init();
+    if (pipeline_back_init() != 0) {
+        printf("Beamformer: array does not fit BEAM_HISTORY\n");
+    }
+    
+#if DSP_DUAL_CORE
+    pipeline_init(&pipeline);
+    multicore_launch_core1(core1_entry);
+#endif
     
     printf("Starting DSP processing...\n");
     
     uint32_t frame_count = 0;
     uint32_t start_time = time_us_32();
     
+    start_sampling();
+    
     while (true) {
-        // Start new sampling
-        start_sampling();
-        
-        // Wait for sampling to complete
-        while (!sampling_complete) {
+        // Wait for the next filled buffer
+        while (blocks_processed == blocks_captured) {
             tight_loop_contents();
         }
         
-        // Process the audio block
-        process_audio_block();
+        // If we fell a whole ring behind, the older buffers have already
+        // been overwritten; skip to the newest complete block
+        uint32_t pending = blocks_captured - blocks_processed;
+        if (pending > CAPTURE_BUFFERS - 1) {
+            blocks_dropped += pending - 1;
+            blocks_processed += pending - 1;
+        }
+        
+        // Process the audio block, then hand its buffer back to the DMA
+        process_audio_block(adc_buffer[blocks_processed % CAPTURE_BUFFERS]);
+        blocks_processed++;
         
         frame_count++;
         
@@ -330,12 +236,13 @@ int main() {
         if (frame_count % 100 == 0) {
             uint32_t elapsed = time_us_32() - start_time;
             float fps = (float)frame_count * 1000000.0f / elapsed;
-            printf("Processed %lu frames, Rate: %.1f FPS\n", 
-                   (unsigned long)frame_count, fps);
+            printf("Processed %lu frames, Rate: %.1f FPS, Overruns: %lu, Dropped: %lu\n", 
+                   (unsigned long)frame_count, fps,
+                   (unsigned long)capture_overruns, (unsigned long)blocks_dropped);
+#if DSP_DUAL_CORE
+            printf("Pipeline stalls: %lu\n", (unsigned long)pipeline.stalls);
+#endif
         }
-        
-        // Optional: Add some delay for testing
-        sleep_ms(10);
     }
     
     return 0;
@@ -0,0 +1,127 @@
+/*
+ * DSP processing pipeline
+ */
+
+#include <stddef.h>
+#include "pipeline.h"
+
+fir_decimator_t channel_fir[ADC_CHANNELS];
+beamformer_t    pipeline_beamformer;
+beam_steering_t pipeline_steering;
+beam_fd_weights_t pipeline_fd_weights;
+gsc_t           pipeline_gsc;
+
+#if BEAM_FREQ_DOMAIN
+static dpa_cpx_t channel_spectra[NUM_SENSORS][FFT_SIZE / 2 + 1];
+#endif
+
+void pipeline_front_init(void) {
+    static const fir_design_t lowpass = {fir_coeffs, FIR_TAPS, FIR_GENERAL, PIPELINE_DPA_MODE};
+    
+    for (int ch = 0; ch < ADC_CHANNELS; ch++) {
+        fir_decimator_init(&channel_fir[ch], &lowpass, DECIMATION_FACTOR, FIR_INPUT_POINT);
+    }
+}
+
+int pipeline_back_init(void) {
+    beam_sensor_t sensors[NUM_SENSORS];
+    for (int s = 0; s < NUM_SENSORS; s++) {
+        sensors[s] = (beam_sensor_t){{s * SENSOR_SPACING_UM, -6}, {0, 0}};
+    }
+    
+    if (beamformer_init(&pipeline_beamformer, sensors, NUM_SENSORS,
+                        SAMPLE_RATE_HZ / DECIMATION_FACTOR,
+                        (dpa_t){SOUND_SPEED_MM_S, -3}, FIR_INPUT_POINT) != 0) {
+        return -1;
+    }
+    if (gsc_init(&pipeline_gsc, NUM_SENSORS, BEAM_ADAPT_TAPS, (dpa_t){BEAM_ADAPT_MU_MILLI, -3},
+                 (dpa_t){1, 0}, BEAM_ADAPT_INTERVAL, FIR_INPUT_POINT) != 0) {
+        return -1;
+    }
+    if (beam_fd_steer(&pipeline_beamformer, (dpa_t){BEAM_STEER_DEG, 0}, &pipeline_fd_weights) != 0) {
+        return -1;
+    }
+    return beam_steer(&pipeline_beamformer, (dpa_t){BEAM_STEER_DEG, 0}, &pipeline_steering);
+}
+
+// Shared-point views of the block's channel rows
+static void pipeline_channels(dsp_block_t *block, int length, dpa_array_t *channels) {
+    for (int ch = 0; ch < ADC_CHANNELS; ch++) {
+        channels[ch] = dpa_array(block->signal[ch], length, block->signal_point);
+    }
+}
+
+void pipeline_front(const uint16_t *adc_samples, dsp_block_t *block) {
+    dpa_array_t channels[ADC_CHANNELS];
+    
+    // De-interleave and convert ADC samples to DPA format
+    adc_demux(adc_samples, block->signal, BUFFER_SIZE);
+    block->signal_point = FIR_INPUT_POINT;
+    
+    // Apply FIR filtering to each channel, computing only the outputs kept
+    // after decimation (in place: DECIMATED_SIZE outputs per row)
+    pipeline_channels(block, BUFFER_SIZE, channels);
+    for (int ch = 0; ch < ADC_CHANNELS; ch++) {
+        fir_decimate_array(&channel_fir[ch], &channels[ch], &channels[ch]);
+    }
+}
+
+void pipeline_back(dsp_block_t *block) {
+    dpa_array_t channels[ADC_CHANNELS];
+    pipeline_channels(block, DECIMATED_SIZE, channels);
+    
+#if BEAM_FREQ_DOMAIN
+    // Transform each channel once and sum the steered spectra
+    if (DECIMATED_SIZE >= FFT_SIZE) {
+        beam_fd_transform_array(channels, NUM_SENSORS, channel_spectra, &block->spectrum_point);
+        beam_fd_form(channel_spectra, &pipeline_fd_weights, block->spectrum);
+    }
+#else
+    dpa_array_t beam = dpa_array(block->beam, DECIMATED_SIZE, 0);
+    
+    // Apply beamforming
+    beamformer_load_array(&pipeline_beamformer, channels);
+#if BEAM_ADAPTIVE
+    gsc_process_array(&pipeline_gsc, &pipeline_beamformer, &pipeline_steering, &beam);
+#else
+    beam_form_array(&pipeline_beamformer, &pipeline_steering, &beam);
+#endif
+    block->beam_point = beam.point;
+    
+    // Optional: Compute FFT of beamformed output
+    if (DECIMATED_SIZE >= FFT_SIZE) {
+        dpa_fft_real_array(&beam, block->spectrum, FFT_SIZE, &block->spectrum_point);
+    }
+#endif
+}
+
+void pipeline_init(dsp_pipeline_t *p) {
+    spsc_init(&p->queue, PIPELINE_DEPTH);
+    p->stalls = 0;
+}
+
+void pipeline_push(dsp_pipeline_t *p, const uint16_t *adc_samples, uint32_t sequence,
+                   void (*wait)(void)) {
+    int slot = spsc_write_slot(&p->queue);
+    if (slot < 0) {
+        // Back stage is behind; wait for it to release a slot
+        p->stalls++;
+        while ((slot = spsc_write_slot(&p->queue)) < 0) {
+            if (wait) wait();
+        }
+    }
+    
+    dsp_block_t *block = &p->blocks[slot];
+    pipeline_front(adc_samples, block);
+    block->sequence = sequence;
+    spsc_commit(&p->queue);
+}
+
+dsp_block_t *pipeline_peek(dsp_pipeline_t *p) {
+    int slot = spsc_read_slot(&p->queue);
+    return slot < 0 ? NULL : &p->blocks[slot];
+}
+
+void pipeline_release(dsp_pipeline_t *p) {
+    spsc_release(&p->queue);
+}
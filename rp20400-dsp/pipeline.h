@@ -0,0 +1,118 @@
+/*
+ * DSP processing pipeline
+ *
+ * process_audio_block split into two stages so they can run on different
+ * cores:
+ *   front - ADC demux + FIR/decimation (owns the per-channel FIR states)
+ *   back  - beamforming + FFT (owns the beamformer state)
+ * Blocks travel from front to back through an SPSC slot queue.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "beamform.h"
+#include "dsp.h"
+#include "fft.h"
+#include "fir.h"
+#include "gsc.h"
+#include "spsc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Blocks in flight between the two stages (power of two)
+#ifndef PIPELINE_DEPTH
+#define PIPELINE_DEPTH     2
+#endif
+
+// Arithmetic of the channel filters: DPA_DECIMAL normalises each output by
+// a power of ten, DPA_BINARY by a shift (coefficients rescaled to a binary
+// point at init). Samples stay at FIR_INPUT_POINT in both modes.
+#ifndef PIPELINE_DPA_MODE
+#define PIPELINE_DPA_MODE  DPA_DECIMAL
+#endif
+
+// Beamform in the frequency domain: FFT each channel, steer with per-bin
+// weights and sum into the spectrum (beam is then left unused). With 0
+// the channels are delay-and-summed in time and the beam is transformed.
+#ifndef BEAM_FREQ_DOMAIN
+#define BEAM_FREQ_DOMAIN   0
+#endif
+
+// Null interference with the adaptive canceller (time-domain path only):
+// BEAM_ADAPT_TAPS NLMS taps per blocking output, step size
+// BEAM_ADAPT_MU_MILLI / 1000, one update every BEAM_ADAPT_INTERVAL samples
+#ifndef BEAM_ADAPTIVE
+#define BEAM_ADAPTIVE      0
+#endif
+#ifndef BEAM_ADAPT_TAPS
+#define BEAM_ADAPT_TAPS    8
+#endif
+#ifndef BEAM_ADAPT_MU_MILLI
+#define BEAM_ADAPT_MU_MILLI 50
+#endif
+#ifndef BEAM_ADAPT_INTERVAL
+#define BEAM_ADAPT_INTERVAL 1
+#endif
+
+// Sample buffers hold bare mantissas, one point per buffer (see
+// dpa_array.h), at half the size of the same buffers in dpa_t
+typedef struct {
+    int32_t   signal[ADC_CHANNELS][BUFFER_SIZE];    // first DECIMATED_SIZE used after FIR
+    int32_t   beam[DECIMATED_SIZE];
+    dpa_cpx_t spectrum[FFT_SIZE / 2 + 1];
+    int8_t    signal_point;
+    int8_t    beam_point;
+    int8_t    spectrum_point;
+    uint32_t  sequence;
+} dsp_block_t;
+
+typedef struct {
+    spsc_queue_t queue;
+    dsp_block_t  blocks[PIPELINE_DEPTH];
+    uint32_t     stalls;   // times the front stage found every slot busy
+} dsp_pipeline_t;
+
+// Per-channel FIR states used by the front stage (a factor-1 decimator is
+// a plain FIR)
+extern fir_decimator_t channel_fir[ADC_CHANNELS];
+
+// Set every channel's FIR state to fir_coeffs with a clear delay line
+void pipeline_front_init(void);
+
+// Beamformer used by the back stage and its look direction
+extern beamformer_t     pipeline_beamformer;
+extern beam_steering_t  pipeline_steering;
+extern beam_fd_weights_t pipeline_fd_weights;
+extern gsc_t            pipeline_gsc;
+
+// Set up the sensor array and steer it to BEAM_STEER_DEG. Returns 0, or -1
+// if the configured array does not fit the beamformer.
+int pipeline_back_init(void);
+
+// Stage 1: de-interleave, convert, FIR-filter and decimate one ADC capture
+void pipeline_front(const uint16_t *adc_samples, dsp_block_t *block);
+
+// Stage 2: beamform the filtered channels and take the spectrum
+void pipeline_back(dsp_block_t *block);
+
+void pipeline_init(dsp_pipeline_t *p);
+
+// Front side: run stage 1 into the next free slot and publish it. While
+// the back stage holds every slot it calls wait (may be NULL) in a loop;
+// each such episode is counted in stalls.
+void pipeline_push(dsp_pipeline_t *p, const uint16_t *adc_samples, uint32_t sequence,
+                   void (*wait)(void));
+
+// Back side: the oldest published block, or NULL if none is ready. Run
+// stage 2 on it, then hand it back with pipeline_release.
+dsp_block_t *pipeline_peek(dsp_pipeline_t *p);
+void pipeline_release(dsp_pipeline_t *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PIPELINE_H
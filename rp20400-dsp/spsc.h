@@ -0,0 +1,57 @@
+/*
+ * Lock-free single-producer / single-consumer slot queue
+ *
+ * The queue only hands out slot indices; the caller owns the slot storage,
+ * so blocks are produced and consumed in place without copying. One side
+ * may run on each RP2040 core (or each host thread): head is written only
+ * by the producer and tail only by the consumer, and acquire/release
+ * ordering publishes the slot contents with the index.
+ */
+
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+typedef struct {
+    atomic_uint head;       // slots committed by the producer
+    atomic_uint tail;       // slots released by the consumer
+    unsigned    capacity;   // number of slots, a power of two
+} spsc_queue_t;
+
+static inline void spsc_init(spsc_queue_t *q, unsigned capacity) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->capacity = capacity;
+}
+
+// Producer: index of the next free slot, or -1 if the queue is full
+static inline int spsc_write_slot(spsc_queue_t *q) {
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail == q->capacity) return -1;
+    return (int)(head & (q->capacity - 1));
+}
+
+// Producer: publish the slot returned by spsc_write_slot
+static inline void spsc_commit(spsc_queue_t *q) {
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+}
+
+// Consumer: index of the oldest committed slot, or -1 if the queue is empty
+static inline int spsc_read_slot(spsc_queue_t *q) {
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (head == tail) return -1;
+    return (int)(tail & (q->capacity - 1));
+}
+
+// Consumer: hand the slot returned by spsc_read_slot back to the producer
+static inline void spsc_release(spsc_queue_t *q) {
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+}
+
+#endif // SPSC_H
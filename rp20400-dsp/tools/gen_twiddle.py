@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+Generate the twiddle tables for the DPA FFT and DFT.
+
+    gen_twiddle.py --fft-max-size 4096 --fft-bits 30 \\
+                   --dft-size 64 --dft-digits 4 -o fft_twiddle.c
+
+Both tables are quarter-wave: entry i holds sin(2*pi*i / size) for i in
+[0, size/4], which is enough to build every twiddle factor of a transform
+of that size (and of every smaller power of two).
+
+  fft_quarter_sine  binary Q(fft_bits) mantissas for dpa_fft
+  dft_quarter_sine  decimal mantissas at point -dft_digits for dpa_dft
+"""
+
+import argparse
+import math
+
+
+def quarter_wave(size, scale):
+    return [int(round(math.sin(2.0 * math.pi * i / size) * scale))
+            for i in range(size // 4 + 1)]
+
+
+def emit_table(name, ctype, values, per_line=8):
+    lines = ["const %s %s[%d] = {" % (ctype, name, len(values))]
+    for i in range(0, len(values), per_line):
+        chunk = ", ".join("%d" % v for v in values[i:i + per_line])
+        sep = "," if i + per_line < len(values) else ""
+        lines.append("    " + chunk + sep)
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def power_of_two(parser, name, value):
+    if value < 4 or value & (value - 1):
+        parser.error("%s must be a power of two >= 4" % name)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--fft-max-size", type=int, default=4096)
+    parser.add_argument("--fft-bits", type=int, default=30)
+    parser.add_argument("--dft-size", type=int, default=64)
+    parser.add_argument("--dft-digits", type=int, default=4)
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    power_of_two(parser, "--fft-max-size", args.fft_max_size)
+    power_of_two(parser, "--dft-size", args.dft_size)
+    if not 1 <= args.fft_bits <= 30:
+        parser.error("--fft-bits must be in [1, 30]")
+    if not 1 <= args.dft_digits <= 9:
+        parser.error("--dft-digits must be in [1, 9]")
+
+    with open(args.output, "w") as out:
+        out.write("/*\n")
+        out.write(" * Generated by tools/gen_twiddle.py --fft-max-size %d --fft-bits %d\n"
+                  % (args.fft_max_size, args.fft_bits))
+        out.write(" *     --dft-size %d --dft-digits %d\n"
+                  % (args.dft_size, args.dft_digits))
+        out.write(" * Do not edit by hand.\n")
+        out.write(" */\n\n")
+        out.write('#include "dsp.h"\n')
+        out.write('#include "fft.h"\n\n')
+        out.write("#if FFT_MAX_SIZE != %d || FFT_TWIDDLE_BITS != %d\n"
+                  % (args.fft_max_size, args.fft_bits))
+        out.write('#error "fft_quarter_sine was generated for a different FFT configuration"\n')
+        out.write("#endif\n\n")
+        out.write("#if FFT_SIZE != %d || DFT_TWIDDLE_DIGITS != %d\n"
+                  % (args.dft_size, args.dft_digits))
+        out.write('#error "dft_quarter_sine was generated for a different DFT configuration"\n')
+        out.write("#endif\n\n")
+        out.write("// sin(2*pi*i / FFT_MAX_SIZE) in Q%d, i = 0..FFT_MAX_SIZE/4\n"
+                  % args.fft_bits)
+        out.write(emit_table("fft_quarter_sine", "int32_t",
+                             quarter_wave(args.fft_max_size, 1 << args.fft_bits)))
+        out.write("\n\n")
+        out.write("// sin(2*pi*i / FFT_SIZE) at point -%d, i = 0..FFT_SIZE/4\n"
+                  % args.dft_digits)
+        out.write(emit_table("dft_quarter_sine", "int32_t",
+                             quarter_wave(args.dft_size, 10 ** args.dft_digits)))
+        out.write("\n")
+
+
+if __name__ == "__main__":
+    main()